@@ -1,27 +1,166 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
+#include <time.h>
+#include <LittleFS.h>
+#include "json_stream.h"
+#include "link_protocol.h"
+#include "tick_log.h"
 
 const char* ssid = "ssid";
 const char* password = "password";
 
-void fetchAndSendBTCData() {
+// API endpoint. Point this at a local HTTP server serving canned /simple/price responses (such as
+// testdata/simple_price.json) to test the whole fetch path without CoinGecko.
+const char* API_BASE = "https://api.coingecko.com/api/v3";
+
+uint8_t linkSeq = 0;  // Frame sequence number; the TM4C uses gaps to count lost frames
+
+// Every price sent is also appended to a capture on flash (see tick_log.h), one segment per power-up, for
+// replaying on the host with "tracker_sim -R ticks.tkl". Copy it off with the LittleFS upload/download tools.
+#define TICK_LOG_FILE  "/ticks.tkl"
+#define TICK_LOG_LIMIT 262144  // Stop logging at 256 KB (roughly 40,000 ticks, two days of fetches)
+Tick_Log tickLog;
+File tickLogFile;
+unsigned long tickLogStartMs = 0;
+bool tickLogStarted = false;  // Segment marker written (waits for the NTP clock so its start time is real)
+
+// Every asset in LINK_ASSET_LIST is fetched with one batched /simple/price request per cycle.
+#define COINGECKO_ID(ticker, id) id,
+const char* const ASSET_IDS[LINK_ASSET_COUNT] = { LINK_ASSET_LIST(COINGECKO_ID) };
+#undef COINGECKO_ID
+
+// Fields read for each asset; the response looks like {"bitcoin":{"usd":..,"usd_24h_change":..,"last_updated_at":..},..}
+#define FIELDS_PER_ASSET 3
+const char* const FIELD_NAMES[FIELDS_PER_ASSET] = { "usd", "usd_24h_change", "last_updated_at" };
+
+char fieldPathText[LINK_ASSET_COUNT * FIELDS_PER_ASSET][32];  // "bitcoin.usd", ...
+const char* fieldPaths[LINK_ASSET_COUNT * FIELDS_PER_ASSET];
+String priceUrl;
+
+struct AssetQuote {
+  double price;
+  double change;
+  uint32_t updated;   // CoinGecko's last_updated_at (Unix seconds)
+  uint8_t found;      // Bit n set when FIELD_NAMES[n] was present
+};
+
+AssetQuote quotes[LINK_ASSET_COUNT];
+
+// Sends one binary price frame (see link_protocol.h) to the TM4C.
+void sendPriceFrame(uint8_t assetId, double price, double change, uint32_t timestamp) {
+  Link_Price p;
+  p.asset_id = assetId;
+  p.price_cents = (int32_t)llround(price * 100.0);
+  long bp = lround(change * 100.0);
+  p.change_bp = (int16_t)(bp > 32767 ? 32767 : bp < -32768 ? -32768 : bp);
+  p.timestamp = timestamp;
+
+  uint8_t frame[LINK_MAX_FRAME];
+  int len = Link_Encode_Price(frame, linkSeq++, &p);
+  Serial.write(frame, len);
+  logTick(p);
+}
+
+// Opens the capture. Logging stays off if the filesystem fails.
+void startTickLog() {
+  if (!LittleFS.begin(true)) return;  // Formats the partition on first use
+  tickLogFile = LittleFS.open(TICK_LOG_FILE, "a");
+}
+
+// Starts this power-up's segment once the clock has been set, so it records when the segment began.
+// Called with the first successful fetch; ticks before it are not logged.
+void startTickSegment(time_t now) {
+  if (!tickLogFile || tickLogStarted || now <= 1600000000) return;
+  uint8_t buf[TICK_LOG_HEADER_SIZE + TICK_LOG_SEGMENT_SIZE];
+  int n = Tick_Log_Start(&tickLog, buf, (uint32_t)now, tickLogFile.size() == 0);
+  tickLogFile.write(buf, n);
+  tickLogStartMs = millis();
+  tickLogStarted = true;
+}
+
+void logTick(const Link_Price& p) {
+  if (!tickLogStarted || tickLogFile.size() >= TICK_LOG_LIMIT) return;
+  uint8_t buf[TICK_LOG_MAX_RECORD];
+  int n = Tick_Log_Encode(&tickLog, buf, millis() - tickLogStartMs, &p);
+  tickLogFile.write(buf, n);
+}
+
+// Builds the batched request URL and the JSON filter paths once at start-up.
+void buildPriceRequest() {
+  priceUrl = String(API_BASE) + "/simple/price?vs_currencies=usd&include_24hr_change=true&include_last_updated_at=true&ids=";
+  for (int i = 0; i < LINK_ASSET_COUNT; i++) {
+    if (i > 0) priceUrl += ",";
+    priceUrl += ASSET_IDS[i];
+    for (int f = 0; f < FIELDS_PER_ASSET; f++) {
+      int n = i * FIELDS_PER_ASSET + f;
+      snprintf(fieldPathText[n], sizeof(fieldPathText[n]), "%s.%s", ASSET_IDS[i], FIELD_NAMES[f]);
+      fieldPaths[n] = fieldPathText[n];
+    }
+  }
+}
+
+void onQuoteField(void* ctx, int filter, const char* text) {
+  AssetQuote* q = &((AssetQuote*)ctx)[filter / FIELDS_PER_ASSET];
+  int field = filter % FIELDS_PER_ASSET;
+  if (field == 0) {
+    q->price = strtod(text, nullptr);
+  } else if (field == 1) {
+    q->change = strtod(text, nullptr);
+  } else {
+    q->updated = (uint32_t)strtoul(text, nullptr, 10);
+  }
+  q->found |= 1 << field;
+}
+
+// Feeds the HTTP body through the JSON filter as it arrives, so the payload is never held in RAM.
+// Stops reading as soon as every filtered field has been seen.
+bool readJsonFields(HTTPClient& http, Json_Stream& js) {
+  WiFiClient* stream = http.getStreamPtr();
+  int remaining = http.getSize();  // -1 when the server sends no Content-Length
+  uint8_t chunk[64];
+  unsigned long lastData = millis();
+
+  while ((http.connected() || stream->available()) && (remaining > 0 || remaining == -1)) {
+    size_t avail = stream->available();
+    if (avail == 0) {
+      if (millis() - lastData > 5000) break;  // Server stalled
+      delay(1);
+      continue;
+    }
+    int n = stream->readBytes(chunk, avail < sizeof(chunk) ? avail : sizeof(chunk));
+    lastData = millis();
+    if (remaining > 0) remaining -= n;
+    for (int i = 0; i < n; i++) {
+      int result = Json_Stream_Feed(&js, (char)chunk[i]);
+      if (result == JSON_ERROR) return false;
+      if (result == JSON_DONE) return true;
+    }
+    if (Json_Stream_All_Found(&js)) return true;
+  }
+  return js.found != 0;
+}
+
+// One HTTP round trip for every asset, then one burst of price frames to the TM4C.
+void fetchAndSendPrices() {
   HTTPClient http;
-  http.begin("https://api.coingecko.com/api/v3/coins/bitcoin?localization=false&tickers=false&market_data=true");
+  http.useHTTP10(true);  // No chunked transfer encoding, so the body can be parsed straight off the socket
+  http.begin(priceUrl);
   int httpCode = http.GET();
 
   if (httpCode == 200) {
-    String payload = http.getString();
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, payload);
+    Json_Stream js;
+    memset(quotes, 0, sizeof(quotes));
+    Json_Stream_Init(&js, fieldPaths, LINK_ASSET_COUNT * FIELDS_PER_ASSET, onQuoteField, quotes);
 
-    if (!error) {
-      float price = doc["market_data"]["current_price"]["usd"];
-      float change = doc["market_data"]["price_change_percentage_24h"];
-
-      char message[128];
-      snprintf(message, sizeof(message), "BTC Price: $%.2f, 24h Change: %.2f%%\n", price, change);
-      Serial.print(message);
+    if (readJsonFields(http, js)) {
+      time_t now = time(nullptr);
+      startTickSegment(now);
+      for (int i = 0; i < LINK_ASSET_COUNT; i++) {
+        if (!(quotes[i].found & 1)) continue;  // Asset missing from the response
+        uint32_t stamp = quotes[i].updated ? quotes[i].updated : (now > 1600000000 ? (uint32_t)now : 0);
+        sendPriceFrame(i, quotes[i].price, quotes[i].change, stamp);
+      }
+      if (tickLogFile) tickLogFile.flush();  // One flash write per fetch cycle
     } else {
       Serial.println("JSON parsing error.");
     }
@@ -47,12 +186,17 @@ void setup() {
   Serial.print("IP Address: ");
   Serial.println(WiFi.localIP());
 
-  // Immediately fetch and send BTC data on startup
-  fetchAndSendBTCData();
+  // Start NTP so price frames carry a real timestamp
+  configTime(0, 0, "pool.ntp.org");
+  buildPriceRequest();
+  startTickLog();
+
+  // Immediately fetch and send prices on startup
+  fetchAndSendPrices();
 }
 
 void loop() {
-  // Fetch and send BTC data every 60 seconds thereafter
+  // Fetch and send prices every 20 seconds thereafter
   delay(20000);
-  fetchAndSendBTCData();
+  fetchAndSendPrices();
 }
@@ -1,11 +1,26 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
+#include <time.h>
+#include "json_stream.h"
+#include "link_protocol.h"
 
 // === WiFi Credentials ===
 const char* ssid = "ssid"; 
 const char* password = "password";
 
+uint8_t linkSeq = 0;  // Frame sequence number; the TM4C uses gaps to count lost frames
+
+// CoinGecko fields we need; everything else in the response is skipped while it streams in
+const char* const PRICE_FIELDS[] = {
+  "market_data.current_price.usd",
+  "market_data.price_change_percentage_24h"
+};
+
+struct PriceFields {
+  double price;
+  double change;
+};
+
 void setup() {
   Serial.begin(115200);
   delay(1000);
@@ -20,14 +35,28 @@ void setup() {
   }
 
   Serial.println("\nWiFi connected.");
+
+  // Start NTP so price frames carry a real timestamp
+  configTime(0, 0, "pool.ntp.org");
 }
 
 void loop() {
-  float price = 0.0;
-  float change = 0.0;
+  double price = 0.0;
+  double change = 0.0;
 
   if (fetchBTCData(price, change)) {
-    Serial.printf("BTC Price: $%.2f | 24h Change: %.2f%%\n", price, change);
+    // Send a binary price frame (see link_protocol.h) instead of a text line
+    Link_Price p;
+    p.asset_id = LINK_ASSET_BTC;
+    p.price_cents = (int32_t)llround(price * 100.0);
+    long bp = lround(change * 100.0);
+    p.change_bp = (int16_t)(bp > 32767 ? 32767 : bp < -32768 ? -32768 : bp);
+    time_t now = time(nullptr);
+    p.timestamp = now > 1600000000 ? (uint32_t)now : 0;  // 0 until NTP has set the clock
+
+    uint8_t frame[LINK_MAX_FRAME];
+    int len = Link_Encode_Price(frame, linkSeq++, &p);
+    Serial.write(frame, len);
   } else {
     Serial.println("Failed to get BTC data.");
   }
@@ -35,20 +64,58 @@ void loop() {
   delay(60000); // Check every 10 seconds
 }
 
-bool fetchBTCData(float &priceOut, float &percentOut) {
+void onPriceField(void* ctx, int filter, const char* text) {
+  PriceFields* fields = (PriceFields*)ctx;
+  if (filter == 0) {
+    fields->price = strtod(text, nullptr);
+  } else {
+    fields->change = strtod(text, nullptr);
+  }
+}
+
+// Feeds the HTTP body through the JSON filter as it arrives, so the payload (tens of KB) is never
+// held in RAM. Stops reading as soon as both fields have been seen.
+bool readPriceFields(HTTPClient& http, PriceFields& fields) {
+  Json_Stream js;
+  Json_Stream_Init(&js, PRICE_FIELDS, 2, onPriceField, &fields);
+
+  WiFiClient* stream = http.getStreamPtr();
+  int remaining = http.getSize();  // -1 when the server sends no Content-Length
+  uint8_t chunk[64];
+  unsigned long lastData = millis();
+
+  while ((http.connected() || stream->available()) && (remaining > 0 || remaining == -1)) {
+    size_t avail = stream->available();
+    if (avail == 0) {
+      if (millis() - lastData > 5000) break;  // Server stalled
+      delay(1);
+      continue;
+    }
+    int n = stream->readBytes(chunk, avail < sizeof(chunk) ? avail : sizeof(chunk));
+    lastData = millis();
+    if (remaining > 0) remaining -= n;
+    for (int i = 0; i < n; i++) {
+      if (Json_Stream_Feed(&js, (char)chunk[i]) == JSON_ERROR) return false;
+    }
+    if (Json_Stream_All_Found(&js)) return true;
+  }
+  return Json_Stream_All_Found(&js);
+}
+
+bool fetchBTCData(double &priceOut, double &percentOut) {
   HTTPClient http;
+  http.useHTTP10(true);  // No chunked transfer encoding, so the body can be parsed straight off the socket
   http.begin("https://api.coingecko.com/api/v3/coins/bitcoin?localization=false&tickers=false&market_data=true");
 
   int httpCode = http.GET();
 
   if (httpCode == 200) {
-    String payload = http.getString();
-    StaticJsonDocument<1024> doc;
-    DeserializationError error = deserializeJson(doc, payload);
+    PriceFields fields = {0.0, 0.0};
 
-    if (!error) {
-      priceOut = doc["market_data"]["current_price"]["usd"];
-      percentOut = doc["market_data"]["price_change_percentage_24h"];
+    if (readPriceFields(http, fields)) {
+      priceOut = fields.price;
+      percentOut = fields.change;
+      http.end();
       return true;
     } else {
       Serial.println("JSON parsing failed.");
@@ -57,5 +124,6 @@ bool fetchBTCData(float &priceOut, float &percentOut) {
     Serial.printf("HTTP error: %d\n", httpCode);
   }
 
+  http.end();
   return false;
 }
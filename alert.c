@@ -0,0 +1,169 @@
+//alert.c
+
+#include "alert.h"
+#include "asset_table.h"          // ASSET_MAX
+
+Alert_Rule alert_rules[ALERT_MAX_RULES];
+int alert_rule_count = 0;
+uint32_t alert_triggers = 0;
+
+// Output patterns, indexed by priority (0 = silent). Bit n is step n of the 8-step cycle.
+const uint8_t alert_buzzer_pattern[4] = { 0x00, 0x00, 0x01, 0x55 };  // none, none, one short beep, beeping
+const uint8_t alert_led_pattern[4]    = { 0x00, 0x0F, 0x55, 0x55 };  // off, slow blink, flash, flash
+
+static int8_t first_rule[ASSET_MAX];  // First rule watching each asset, or -1 (set up by the first Alert_Add)
+
+int Alert_Add(int type, int asset, int32_t level, int32_t hysteresis, uint32_t window_ms, int priority) {
+    if (alert_rule_count >= ALERT_MAX_RULES || asset < 0 || asset >= ASSET_MAX)
+        return -1;
+    if (alert_rule_count == 0) {
+        for (int id = 0; id < ASSET_MAX; id++)
+            first_rule[id] = -1;  // Empty per-asset lists.
+    }
+    int rule = alert_rule_count++;
+    Alert_Rule *r = &alert_rules[rule];
+    r->type = (uint8_t)type;
+    r->asset = (uint8_t)asset;
+    r->priority = (uint8_t)priority;
+    r->state = ALERT_ARMED;
+    r->level = level;
+    r->hysteresis = hysteresis;
+    r->window_ms = window_ms ? window_ms : 1;  // A zero window would divide by zero.
+    r->next = -1;
+    // Append to the asset's list, so rules on one asset are evaluated in the order they were added.
+    int8_t *link = &first_rule[asset];
+    while (*link >= 0)
+        link = &alert_rules[*link].next;
+    *link = (int8_t)rule;
+    return rule;
+}
+
+void Alert_Set_Level(int rule, int32_t level, int32_t hysteresis) {
+    if (rule < 0 || rule >= alert_rule_count)
+        return;
+    alert_rules[rule].level = level;
+    alert_rules[rule].hysteresis = hysteresis;
+    alert_rules[rule].state = ALERT_ARMED;  // Judge the next price against the new level from scratch.
+}
+
+// Returns the move from 'from' to 'to' in basis points of 'from'.
+static int32_t Move_Bp(int32_t from, int32_t to) {
+    if (from <= 0)
+        return 0;
+    return (int32_t)(((int64_t)to - from) * 10000 / from);  // 64-bit: cents * 10000 overflows 32 bits.
+}
+
+// Updates the MOVE rule's sub-windows with a new price and returns the move in bp: the drop from the
+// window's high if the rule watches drops (level < 0), otherwise the rise from the window's low.
+static int32_t Measure_Move(Alert_Rule *r, int32_t cents, uint32_t now_ms) {
+    uint32_t span = r->window_ms / ALERT_BUCKETS;  // Length of one sub-window
+    if (span == 0)
+        span = 1;
+    if (!r->started) {
+        for (int b = 0; b < ALERT_BUCKETS; b++)
+            r->high[b] = r->low[b] = cents;
+        r->bucket = 0;
+        r->ref_ms = now_ms;
+    }
+    // Step into the sub-window that holds 'now', restarting every sub-window passed on the way.
+    for (int b = 0; b < ALERT_BUCKETS && now_ms - r->ref_ms >= span; b++) {
+        r->bucket = (uint8_t)((r->bucket + 1) % ALERT_BUCKETS);
+        r->high[r->bucket] = r->low[r->bucket] = cents;
+        r->ref_ms += span;
+    }
+    if (now_ms - r->ref_ms >= span)
+        r->ref_ms = now_ms;       // Idle for longer than the whole window: every sub-window was restarted.
+    if (cents > r->high[r->bucket])
+        r->high[r->bucket] = cents;
+    if (cents < r->low[r->bucket])
+        r->low[r->bucket] = cents;
+    int32_t high = r->high[0], low = r->low[0];
+    for (int b = 1; b < ALERT_BUCKETS; b++) {
+        if (r->high[b] > high)
+            high = r->high[b];
+        if (r->low[b] < low)
+            low = r->low[b];
+    }
+    return r->level < 0 ? Move_Bp(high, cents) : Move_Bp(low, cents);
+}
+
+// Returns the RATE rule's change in bp per minute, remeasured once every window_ms (the previous value
+// is kept in between).
+static int32_t Measure_Rate(Alert_Rule *r, int32_t cents, uint32_t now_ms) {
+    if (!r->started) {
+        r->ref_price = cents;
+        r->ref_ms = now_ms;
+        return 0;
+    }
+    uint32_t elapsed = now_ms - r->ref_ms;
+    if (elapsed < r->window_ms)
+        return r->value;
+    int32_t rate = (int32_t)((int64_t)Move_Bp(r->ref_price, cents) * 60000 / elapsed);
+    r->ref_price = cents;
+    r->ref_ms = now_ms;
+    return rate;
+}
+
+int Alert_Evaluate(int asset, int32_t cents, uint32_t now_ms) {
+    int fired = 0;
+    if (asset < 0 || asset >= ASSET_MAX || alert_rule_count == 0)
+        return 0;
+    for (int rule = first_rule[asset]; rule >= 0; rule = alert_rules[rule].next) {
+        Alert_Rule *r = &alert_rules[rule];
+        int32_t v;
+        if (r->type == ALERT_MOVE)
+            v = Measure_Move(r, cents, now_ms);
+        else if (r->type == ALERT_RATE)
+            v = Measure_Rate(r, cents, now_ms);
+        else
+            v = cents;
+        r->started = 1;
+        r->value = v;
+        // Falling rules trigger at or below the level and re-arm at level + hysteresis; rising rules mirror it.
+        int falling = r->type == ALERT_BELOW || (r->type != ALERT_ABOVE && r->level < 0);
+        int hit, clear;
+        if (falling) {
+            hit = r->type == ALERT_BELOW ? v < r->level : v <= r->level;
+            clear = v >= r->level + r->hysteresis;
+        } else {
+            hit = r->type == ALERT_ABOVE ? v > r->level : v >= r->level;
+            clear = v <= r->level - r->hysteresis;
+        }
+        if (r->state == ALERT_ARMED) {
+            if (hit) {
+                r->state = ALERT_ACTIVE;
+                r->triggers++;
+                alert_triggers++;
+                fired++;
+            }
+        } else if (clear && !hit) {
+            r->state = ALERT_ARMED;  // Back past the hysteresis band: ready for the next crossing.
+        }
+    }
+    return fired;
+}
+
+int Alert_Active(uint32_t now_ms) {
+    int best = -1;
+    for (int rule = 0; rule < alert_rule_count; rule++) {
+        Alert_Rule *r = &alert_rules[rule];
+        if (r->state == ALERT_SNOOZED && (int32_t)(now_ms - r->snooze_until) >= 0)
+            r->state = ALERT_ACTIVE;  // Snooze is over and the condition has not cleared.
+        if (r->state == ALERT_ACTIVE && (best < 0 || r->priority > alert_rules[best].priority))
+            best = rule;
+    }
+    return best;
+}
+
+void Alert_Acknowledge(int rule) {
+    if (rule < 0 || rule >= alert_rule_count || alert_rules[rule].state == ALERT_ARMED)
+        return;
+    alert_rules[rule].state = ALERT_ACKED;
+}
+
+void Alert_Snooze(int rule, uint32_t ms, uint32_t now_ms) {
+    if (rule < 0 || rule >= alert_rule_count || alert_rules[rule].state == ALERT_ARMED)
+        return;
+    alert_rules[rule].state = ALERT_SNOOZED;
+    alert_rules[rule].snooze_until = now_ms + ms;
+}
@@ -0,0 +1,68 @@
+//alert.h
+#ifndef ALERT_H                   // Prevent multiple inclusions
+#define ALERT_H
+
+#include "tracker.h"              // int32_t, uint32_t
+
+#define ALERT_MAX_RULES 16        // Fixed rule table size (no dynamic allocation)
+#define ALERT_BUCKETS   4         // Sub-windows a MOVE rule keeps its high/low in
+
+// Rule types. Prices are in cents, moves and rates in basis points (1 bp = 0.01 %); for MOVE and RATE the
+// sign of 'level' gives the direction (-500 = a 5 % drop, +500 = a 5 % rise).
+#define ALERT_BELOW 0             // Price < level; re-arms once price >= level + hysteresis
+#define ALERT_ABOVE 1             // Price > level; re-arms once price <= level - hysteresis
+#define ALERT_MOVE  2             // Price moved 'level' bp from the window's high (drop) or low (rise)
+#define ALERT_RATE  3             // Price changed faster than 'level' bp per minute, measured over window_ms
+
+// Rule states:
+#define ALERT_ARMED   0           // Waiting for the condition
+#define ALERT_ACTIVE  1           // Triggered and sounding
+#define ALERT_ACKED   2           // Triggered, silenced by the user until the rule re-arms
+#define ALERT_SNOOZED 3           // Triggered, silenced until snooze_until; sounds again if still triggered
+
+// Priorities (index into the output patterns):
+#define ALERT_LOW    1            // LED blink only
+#define ALERT_MEDIUM 2            // LED flash and a short beep every 1.2 s
+#define ALERT_HIGH   3            // LED flash and continuous beeping
+
+typedef struct {
+    uint8_t type;                 // ALERT_BELOW .. ALERT_RATE
+    uint8_t asset;                // Asset id the rule watches
+    uint8_t priority;             // ALERT_LOW .. ALERT_HIGH
+    uint8_t state;                // ALERT_ARMED .. ALERT_SNOOZED
+    int32_t level;                // Trigger level (cents, or bp / bp per minute)
+    int32_t hysteresis;           // Distance back past 'level' before the rule re-arms (same unit)
+    uint32_t window_ms;           // MOVE: look-back window; RATE: measurement interval
+    uint32_t snooze_until;        // SysTick_Millis() at which a snoozed rule sounds again
+    uint32_t triggers;            // Times the rule went from armed to active
+    int32_t value;                // Last measured value (price, move or rate) for the alert screen
+    // Evaluation state:
+    uint8_t started;              // 1 once the first price has been seen
+    uint8_t bucket;               // MOVE: current sub-window
+    int8_t next;                  // Next rule watching the same asset, or -1
+    int32_t ref_price;            // RATE: price at the start of the measurement interval
+    uint32_t ref_ms;              // RATE: start of the interval; MOVE: start of the current sub-window
+    int32_t high[ALERT_BUCKETS];  // MOVE: highest price seen in each sub-window
+    int32_t low[ALERT_BUCKETS];   // MOVE: lowest price seen in each sub-window
+} Alert_Rule;
+
+extern Alert_Rule alert_rules[ALERT_MAX_RULES];
+extern int alert_rule_count;      // Rules in use
+extern uint32_t alert_triggers;   // Armed-to-active transitions over all rules
+
+// Output patterns per priority: bit n (n = 0..7) is step n of a 1.2 s cycle played at ALERT_CADENCE_MS.
+extern const uint8_t alert_buzzer_pattern[4];
+extern const uint8_t alert_led_pattern[4];
+
+int Alert_Add(int type, int asset, int32_t level, int32_t hysteresis, uint32_t window_ms, int priority);
+// Append a rule (armed). Returns its id, or -1 if the table is full or the asset id is out of range.
+void Alert_Set_Level(int rule, int32_t level, int32_t hysteresis);  // Change a rule's level and re-arm it
+int Alert_Evaluate(int asset, int32_t cents, uint32_t now_ms);
+// Run the asset's rules against a new price. Only that asset's rules are visited, so the cost per price is
+// bounded by the rules on one asset. Returns the number of rules that triggered on this price.
+int Alert_Active(uint32_t now_ms);
+// Highest-priority rule that is sounding (lowest id on a tie), or -1. Snoozes that have expired sound again.
+void Alert_Acknowledge(int rule); // Silence an active rule until its condition clears
+void Alert_Snooze(int rule, uint32_t ms, uint32_t now_ms);  // Silence a triggered rule for 'ms'
+
+#endif // ALERT_H
@@ -0,0 +1,275 @@
+//alert_test.c
+// Host test for the alert engine in alert.c: replays random price series for several assets through
+// Alert_Evaluate, with random snoozes and acknowledgements, and checks every tick against a reference model
+// written from the rule definitions in alert.h. Build:
+//   cc -O2 -DTRACKER_HOST -o alert_test alert_test.c alert.c
+// Usage:
+//   alert_test [-n ticks] [-s seed]   Exits non-zero if any check fails
+//
+// Checks, on every tick:
+//   value    BELOW/ABOVE see the price; RATE the change per minute over its measurement interval; MOVE a
+//            move from a window high/low that covers at least the last 3/4 of window_ms and at most all of it
+//            (the engine keeps ALERT_BUCKETS sub-windows)
+//   trigger  a rule fires exactly when the reference says it crosses its level while armed: none missed,
+//            none twice without passing back through the hysteresis band
+//   sound    Alert_Active returns the rule the reference expects, with snoozes and acknowledgements applied
+
+#include "alert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ASSETS      3             // BTC, ETH, SOL
+#define TICKS_MAX   1000000
+
+typedef struct {
+    int type, asset, priority;
+    int32_t level, hysteresis;
+    uint32_t window_ms;
+} Rule_Spec;
+
+static const Rule_Spec specs[] = {
+    { ALERT_BELOW, 0, ALERT_HIGH,   6000000, 5000,    0       },
+    { ALERT_ABOVE, 0, ALERT_LOW,    7000000, 5000,    0       },
+    { ALERT_MOVE,  0, ALERT_HIGH,   -500,    100,     3600000 },
+    { ALERT_MOVE,  0, ALERT_MEDIUM, 300,     100,     1800000 },
+    { ALERT_RATE,  0, ALERT_HIGH,   -100,    50,      300000  },
+    { ALERT_BELOW, 1, ALERT_MEDIUM, 300000,  2000,    0       },
+    { ALERT_MOVE,  1, ALERT_LOW,    -300,    50,      900001  },  // Window not a multiple of ALERT_BUCKETS
+    { ALERT_RATE,  1, ALERT_MEDIUM, 50,      25,      600000  },
+    { ALERT_ABOVE, 2, ALERT_MEDIUM, 16000,   0,       0       },  // No hysteresis
+    { ALERT_MOVE,  2, ALERT_HIGH,   800,     200,     7200000 },
+};
+#define RULES ((int)(sizeof(specs) / sizeof(specs[0])))
+
+static const int32_t start_cents[ASSETS] = { 6500000, 320000, 15000 };
+
+// Reference state per rule.
+typedef struct {
+    int state;                    // ALERT_ARMED .. ALERT_SNOOZED
+    uint32_t snooze_until;
+    uint32_t triggers;
+    int started;
+    int32_t rate, ref_price;      // RATE: last measured rate and the interval's start
+    uint32_t ref_ms;
+} Reference;
+
+static Reference ref[RULES];
+static uint32_t tick_ms[ASSETS][TICKS_MAX];
+static int32_t tick_cents[ASSETS][TICKS_MAX];
+static int tick_count[ASSETS];
+static int failures = 0;
+static uint32_t value_errors = 0, missed = 0, duplicates = 0, sound_errors = 0;
+
+static void Fail(const char *check, int rule, uint32_t now, const char *what, long a, long b) {
+    if (failures++ < 10)
+        printf("FAIL %-8s rule %d at %lu ms: %s (%ld, expected %ld)\n", check, rule, (unsigned long)now, what, a, b);
+}
+
+static int32_t Move_Bp(int32_t from, int32_t to) {
+    if (from <= 0)
+        return 0;
+    return (int32_t)(((int64_t)to - from) * 10000 / from);
+}
+
+// Bounds on a MOVE rule's value from the asset's ticks: the inner window (last 3 sub-windows) is always
+// covered by the engine's buckets, the outer one (last 4) is the most they can hold.
+static void Move_Bounds(const Rule_Spec *s, int32_t cents, uint32_t now, int32_t *lo, int32_t *hi) {
+    uint32_t span = s->window_ms / ALERT_BUCKETS;
+    int a = s->asset;
+    int32_t inner_high = cents, inner_low = cents, outer_high = cents, outer_low = cents;
+    if (span == 0)
+        span = 1;
+    for (int i = tick_count[a] - 1; i >= 0 && now - tick_ms[a][i] < 4 * span; i--) {
+        int32_t c = tick_cents[a][i];
+        if (c > outer_high)
+            outer_high = c;
+        if (c < outer_low)
+            outer_low = c;
+        if (now - tick_ms[a][i] <= 3 * span) {
+            if (c > inner_high)
+                inner_high = c;
+            if (c < inner_low)
+                inner_low = c;
+        }
+    }
+    if (s->level < 0) {           // Drop from the high: a higher high is a bigger drop.
+        *lo = Move_Bp(outer_high, cents);
+        *hi = Move_Bp(inner_high, cents);
+    } else {                      // Rise from the low.
+        *lo = Move_Bp(inner_low, cents);
+        *hi = Move_Bp(outer_low, cents);
+    }
+}
+
+// Reference value of a RATE rule: bp per minute between the interval's first price and the first price
+// at least window_ms later, held until the next interval completes.
+static int32_t Rate_Value(Reference *f, const Rule_Spec *s, int32_t cents, uint32_t now) {
+    if (!f->started) {
+        f->ref_price = cents;
+        f->ref_ms = now;
+        f->rate = 0;
+    } else if (now - f->ref_ms >= s->window_ms) {
+        f->rate = (int32_t)((int64_t)Move_Bp(f->ref_price, cents) * 60000 / (now - f->ref_ms));
+        f->ref_price = cents;
+        f->ref_ms = now;
+    }
+    return f->rate;
+}
+
+// Applies one value to the reference state machine; returns 1 if the rule fires.
+static int Reference_Step(Reference *f, const Rule_Spec *s, int32_t v) {
+    int falling = s->type == ALERT_BELOW || (s->type != ALERT_ABOVE && s->level < 0);
+    int hit, clear;
+    if (falling) {
+        hit = s->type == ALERT_BELOW ? v < s->level : v <= s->level;
+        clear = v >= s->level + s->hysteresis;
+    } else {
+        hit = s->type == ALERT_ABOVE ? v > s->level : v >= s->level;
+        clear = v <= s->level - s->hysteresis;
+    }
+    if (f->state == ALERT_ARMED) {
+        if (hit) {
+            f->state = ALERT_ACTIVE;
+            f->triggers++;
+            return 1;
+        }
+    } else if (clear && !hit) {
+        f->state = ALERT_ARMED;
+    }
+    return 0;
+}
+
+// The rule the reference says is sounding.
+static int Reference_Active(uint32_t now) {
+    int best = -1;
+    for (int i = 0; i < RULES; i++) {
+        if (ref[i].state == ALERT_SNOOZED && (int32_t)(now - ref[i].snooze_until) >= 0)
+            ref[i].state = ALERT_ACTIVE;
+        if (ref[i].state == ALERT_ACTIVE && (best < 0 || specs[i].priority > specs[best].priority))
+            best = i;
+    }
+    return best;
+}
+
+// Next price of a mean-reverting random walk with occasional jumps.
+static int32_t Next_Price(int asset, int32_t cents) {
+    double p = cents, start = start_cents[asset];
+    double step = ((double)rand() / RAND_MAX - 0.5) * 0.006;  // Up to +-0.3 % per tick
+    if (rand() % 500 == 0)
+        step *= 25;               // Flash move of up to +-7.5 %
+    p += p * step + (start - p) * 0.002;
+    return p < 1 ? 1 : (int32_t)p;
+}
+
+static void Replay(int count) {
+    int32_t cents[ASSETS];
+    uint32_t now = 0;
+    int sounding = -1;
+    for (int a = 0; a < ASSETS; a++)
+        cents[a] = start_cents[a];
+    for (int n = 0; n < count; n++) {
+        int a = rand() % ASSETS;
+        now += rand() % 20 == 0 ? 1 + (uint32_t)rand() % 7200000 : 1000 + (uint32_t)rand() % 39000;  // Some gaps
+        cents[a] = Next_Price(a, cents[a]);
+
+        // The user reacts to some alerts: snooze for up to 10 minutes, or acknowledge.
+        if (sounding >= 0 && rand() % 8 == 0) {
+            if (rand() % 2) {
+                uint32_t ms = 1 + (uint32_t)rand() % 600000;
+                Alert_Snooze(sounding, ms, now);
+                ref[sounding].state = ALERT_SNOOZED;
+                ref[sounding].snooze_until = now + ms;
+            } else {
+                Alert_Acknowledge(sounding);
+                ref[sounding].state = ALERT_ACKED;
+            }
+        }
+
+        int fired = Alert_Evaluate(a, cents[a], now), expected_fired = 0;
+        for (int i = 0; i < RULES; i++) {
+            const Rule_Spec *s = &specs[i];
+            Alert_Rule *r = &alert_rules[i];
+            if (s->asset != a)
+                continue;
+            int32_t v = r->value;
+            if (s->type == ALERT_MOVE) {
+                int32_t lo, hi;
+                Move_Bounds(s, cents[a], now, &lo, &hi);
+                if (v < lo || v > hi) {
+                    Fail("value", i, now, "move outside the window bounds", v, v < lo ? lo : hi);
+                    value_errors++;
+                }
+            } else {
+                int32_t want = s->type == ALERT_RATE ? Rate_Value(&ref[i], s, cents[a], now) : cents[a];
+                if (v != want) {
+                    Fail("value", i, now, "value", v, want);
+                    value_errors++;
+                    v = want;
+                }
+            }
+            ref[i].started = 1;
+            uint32_t before = ref[i].triggers;
+            expected_fired += Reference_Step(&ref[i], s, v);
+            if (r->triggers != ref[i].triggers) {
+                int was_missed = r->triggers < ref[i].triggers;
+                Fail("trigger", i, now, was_missed ? "missed" : "fired again or without a crossing",
+                     (long)r->triggers - (long)before, (long)ref[i].triggers - (long)before);
+                missed += was_missed;
+                duplicates += !was_missed;
+                r->triggers = ref[i].triggers;  // Resynchronize so one fault is reported once.
+                r->state = (uint8_t)ref[i].state;
+            }
+        }
+        if (fired != expected_fired)
+            Fail("trigger", -1, now, "Alert_Evaluate return value", fired, expected_fired);
+
+        int active = Alert_Active(now), want = Reference_Active(now);
+        if (active != want) {
+            Fail("sound", active, now, "Alert_Active", active, want);
+            sound_errors++;
+        }
+        sounding = active;
+        if (tick_count[a] < TICKS_MAX) {
+            tick_ms[a][tick_count[a]] = now;
+            tick_cents[a][tick_count[a]++] = cents[a];
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int count = 300000, opt;
+    unsigned seed = 1;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            count = atoi(optarg);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    if (count > TICKS_MAX)
+        count = TICKS_MAX;        // One asset never gets more ticks than this either.
+    srand(seed);
+    for (int i = 0; i < RULES; i++) {
+        const Rule_Spec *s = &specs[i];
+        if (Alert_Add(s->type, s->asset, s->level, s->hysteresis, s->window_ms, s->priority) != i) {
+            printf("FAIL rule table full\n");
+            return 1;
+        }
+    }
+    Replay(count);
+
+    static const char *const type_names[] = { "BELOW", "ABOVE", "MOVE", "RATE" };
+    printf("%d ticks on %d assets (ticks 1-40 s apart, some gaps of up to 2 h), %d rules\n\n", count, ASSETS, RULES);
+    printf("rule  type   asset      level  hyst   window_ms  triggers\n");
+    for (int i = 0; i < RULES; i++)
+        printf("%4d  %-5s  %5d  %9ld  %4ld  %10lu  %8lu\n", i, type_names[specs[i].type], specs[i].asset,
+               (long)specs[i].level, (long)specs[i].hysteresis, (unsigned long)specs[i].window_ms,
+               (unsigned long)ref[i].triggers);
+    printf("\n%lu triggers: %lu missed, %lu duplicate or spurious, %lu value errors, %lu wrong sounding rules\n",
+           (unsigned long)alert_triggers, (unsigned long)missed, (unsigned long)duplicates,
+           (unsigned long)value_errors, (unsigned long)sound_errors);
+    return failures != 0;
+}
@@ -0,0 +1,58 @@
+//asset_table.c
+
+#include "asset_table.h"
+
+int32_t asset_price[ASSET_MAX];
+int16_t asset_change[ASSET_MAX];
+uint32_t asset_timestamp[ASSET_MAX];
+uint32_t asset_updated_ms[ASSET_MAX];
+uint8_t asset_flags[ASSET_MAX];
+
+typedef char asset_list_fits_table[(LINK_ASSET_COUNT <= ASSET_MAX) ? 1 : -1];  // Compile-time size check.
+
+#define ASSET_TICKER(ticker, id) #ticker,
+const char *const asset_ticker[ASSET_MAX] = { LINK_ASSET_LIST(ASSET_TICKER) };
+#undef ASSET_TICKER
+
+void Asset_Update(int id, int32_t cents, int16_t change_bp, uint32_t timestamp) {
+    if (id < 0 || id >= ASSET_MAX)
+        return;                   // Unknown asset (newer ESP32 list): ignore it.
+    asset_price[id] = cents;
+    asset_change[id] = change_bp;
+    asset_timestamp[id] = timestamp;
+    asset_updated_ms[id] = SysTick_Millis();
+    asset_flags[id] = (uint8_t)((asset_flags[id] | ASSET_VALID) & ~ASSET_STALE);
+}
+
+void Asset_Restore(int id, int32_t cents, int16_t change_bp, uint32_t timestamp) {
+    if (id < 0 || id >= ASSET_MAX)
+        return;
+    asset_price[id] = cents;
+    asset_change[id] = change_bp;
+    asset_timestamp[id] = timestamp;
+    asset_updated_ms[id] = 0;
+    asset_flags[id] |= ASSET_VALID | ASSET_STALE;
+}
+
+int Asset_Count_Valid(void) {
+    int count = 0;
+    for (int id = 0; id < ASSET_MAX; id++)
+        count += (asset_flags[id] & ASSET_VALID) != 0;
+    return count;
+}
+
+int Asset_Next_Valid(int id) {
+    for (int step = 1; step <= ASSET_MAX; step++) {
+        int next = (id + step) % ASSET_MAX;
+        if (asset_flags[next] & ASSET_VALID)
+            return next;
+    }
+    return -1;
+}
+
+int Asset_Valid_Position(int id) {
+    int position = 0;
+    for (int i = 0; i <= id && i < ASSET_MAX; i++)
+        position += (asset_flags[i] & ASSET_VALID) != 0;
+    return position;
+}
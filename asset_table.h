@@ -0,0 +1,31 @@
+//asset_table.h
+#ifndef ASSET_TABLE_H             // Prevent multiple inclusions
+#define ASSET_TABLE_H
+
+#include "tracker.h"              // int32_t, SysTick_Millis()
+#include "link_protocol.h"        // LINK_ASSET_LIST and the asset ids
+
+#define ASSET_MAX 10              // Table capacity; asset ids at or above this are ignored
+
+// Per-asset flags:
+#define ASSET_VALID 0x01          // At least one price has been received
+#define ASSET_STALE 0x02          // Price restored from the EEPROM cache; cleared by the first live price
+
+// Per-asset state, stored as parallel arrays indexed by asset id (struct-of-arrays), so a scan over one
+// field (e.g. every price) touches only that field's memory.
+extern int32_t asset_price[ASSET_MAX];       // Last price in cents
+extern int16_t asset_change[ASSET_MAX];      // Last 24h change in basis points
+extern uint32_t asset_timestamp[ASSET_MAX];  // Sender's Unix timestamp of the last price (0 if unknown)
+extern uint32_t asset_updated_ms[ASSET_MAX]; // SysTick_Millis() when the last price arrived
+extern uint8_t asset_flags[ASSET_MAX];       // ASSET_* flags
+extern const char *const asset_ticker[ASSET_MAX];  // Display name ("BTC"); 0 for unused ids
+
+void Asset_Update(int id, int32_t cents, int16_t change_bp, uint32_t timestamp);
+// Store a new price (ignores ids >= ASSET_MAX). Alert rules are evaluated separately (see alert.h).
+void Asset_Restore(int id, int32_t cents, int16_t change_bp, uint32_t timestamp);
+// Store a price from the warm-start cache: valid for display but marked ASSET_STALE (no arrival time).
+int Asset_Count_Valid(void);      // Number of assets that have received a price
+int Asset_Next_Valid(int id);     // Next asset after 'id' that has a price (wrapping), or -1 if none
+int Asset_Valid_Position(int id); // 1-based position of 'id' among the valid assets (for "2/5" page labels)
+
+#endif // ASSET_TABLE_H
@@ -0,0 +1,190 @@
+//config_store.c
+
+#include "config_store.h"
+#include "link_protocol.h"        // Link_Crc16
+
+#define BLOCK_WORDS    16
+#define EEPROM_BLOCKS  32
+#define CONFIG_WORDS   (3 + 4 * ALERT_MAX_RULES)
+#define CACHE_WORDS    (2 + 3 * ASSET_MAX)
+#define RECORD_MAX     CONFIG_WORDS
+
+typedef char store_layout_ok[(STORE_CONFIG_BLOCK + STORE_CONFIG_SLOT * STORE_CONFIG_SLOTS <= STORE_CACHE_BLOCK &&
+                              STORE_CACHE_BLOCK + STORE_CACHE_SLOT * STORE_CACHE_SLOTS <= EEPROM_BLOCKS &&
+                              CONFIG_WORDS <= STORE_CONFIG_SLOT * BLOCK_WORDS &&
+                              CACHE_WORDS <= STORE_CACHE_SLOT * BLOCK_WORDS &&
+                              CACHE_WORDS <= RECORD_MAX) ? 1 : -1];
+
+static const uint8_t region_block[2] = { STORE_CONFIG_BLOCK, STORE_CACHE_BLOCK };
+static const uint8_t region_slot[2] = { STORE_CONFIG_SLOT, STORE_CACHE_SLOT };
+static const uint8_t region_slots[2] = { STORE_CONFIG_SLOTS, STORE_CACHE_SLOTS };
+static const uint8_t record_words[2] = { CONFIG_WORDS, CACHE_WORDS };
+
+uint32_t store_writes = 0;
+uint32_t store_errors = 0;
+
+static int enabled = 0;           // 1 once the EEPROM has started without errors
+static uint16_t next_seq[2];      // Sequence number of the next record of each kind
+static uint8_t next_slot[2];      // Slot the next record of each kind goes to
+static uint8_t pending = 0;       // Bit per kind: a record is waiting to be written
+static uint8_t config_index = 0, config_rule = 0;  // Picker state for the queued config record
+static uint32_t record[RECORD_MAX];  // Record being read or written
+static uint32_t record_len = 0, record_sent = 0;
+static uint8_t record_block = 0;  // First block of the slot being written
+
+// CRC of a record with the CRC field (upper half of word 1) taken as zero.
+static uint16_t Record_Crc(uint32_t len) {
+    uint32_t saved = record[1];
+    record[1] &= 0xFFFF;
+    uint16_t crc = Link_Crc16((const uint8_t *)record, len * 4);
+    record[1] = saved;
+    return crc;
+}
+
+// Reads a slot into record[]; returns 1 if it holds a valid record of this kind and version.
+static int Read_Slot(int kind, int slot) {
+    int block = region_block[kind] + slot * region_slot[kind];
+    for (int i = 0; i < record_words[kind]; i++) {
+        if ((i & (BLOCK_WORDS - 1)) == 0) {
+            EEPROM->EEBLOCK = (uint32_t)(block + i / BLOCK_WORDS);
+            EEPROM->EEOFFSET = 0;  // EERDWRINC stays within the block, so set each block explicitly.
+        }
+        record[i] = EEPROM_READ_INC();
+    }
+    if (record[0] == 0xFFFFFFFF)
+        return 0;                 // Erased: never written.
+    if (record[0] != (STORE_MAGIC | STORE_VERSION << 16 | (uint32_t)kind << 24) ||
+        Record_Crc(record_words[kind]) != record[1] >> 16) {
+        store_errors++;           // Torn write, older layout or corruption.
+        return 0;
+    }
+    return 1;
+}
+
+// Loads the newest valid record of a kind into record[]; returns its slot, or -1 if there is none.
+static int Read_Newest(int kind) {
+    int best = -1;
+    uint16_t best_seq = 0;
+    for (int slot = 0; slot < region_slots[kind]; slot++) {
+        if (!Read_Slot(kind, slot))
+            continue;
+        uint16_t seq = (uint16_t)record[1];
+        if (best < 0 || (int16_t)(seq - best_seq) > 0) {
+            best = slot;
+            best_seq = seq;
+        }
+    }
+    if (best >= 0)
+        Read_Slot(kind, best);
+    return best;
+}
+
+int Store_Init(void) {
+    SYSCTL->RCGCEEPROM |= 0x01;   // Enable the EEPROM module clock.
+    while ((SYSCTL->PREEPROM & 0x01) == 0) { }  // Wait until the module is ready.
+    while (EEPROM->EEDONE & 0x01) { }           // WORKING: wait for the power-up recovery to finish.
+    if (EEPROM->EESUPP & 0x0C) {  // PRETRY or ERETRY: the module could not recover a previous operation.
+        store_errors++;
+        return 0;
+    }
+    enabled = 1;
+    for (int kind = STORE_CONFIG; kind <= STORE_CACHE; kind++) {
+        int slot = Read_Newest(kind);
+        next_slot[kind] = slot < 0 ? 0 : (uint8_t)((slot + 1) % region_slots[kind]);
+        next_seq[kind] = slot < 0 ? 0 : (uint16_t)(record[1] + 1);
+    }
+    return 1;
+}
+
+int Store_Load_Config(int *threshold_index, int *threshold_rule) {
+    if (!enabled || Read_Newest(STORE_CONFIG) < 0)
+        return 0;
+    int count = (int)(record[2] >> 16 & 0xFF);
+    if (count > ALERT_MAX_RULES || alert_rule_count != 0)
+        return 0;
+    for (int i = 0; i < count; i++) {
+        const uint32_t *r = &record[3 + 4 * i];
+        Alert_Add((int)(r[0] & 0xFF), (int)(r[0] >> 8 & 0xFF), (int32_t)r[1], (int32_t)r[2], r[3],
+                  (int)(r[0] >> 16 & 0xFF));
+    }
+    *threshold_index = (int)(record[2] & 0xFF);
+    *threshold_rule = (int)(record[2] >> 8 & 0xFF) < alert_rule_count ? (int)(record[2] >> 8 & 0xFF) : -1;
+    return 1;
+}
+
+int Store_Load_Cache(void) {
+    if (!enabled || Read_Newest(STORE_CACHE) < 0)
+        return 0;
+    int restored = 0;
+    for (int id = 0; id < ASSET_MAX; id++) {
+        const uint32_t *a = &record[2 + 3 * id];
+        if ((a[1] >> 16) & ASSET_VALID) {
+            Asset_Restore(id, (int32_t)a[0], (int16_t)a[1], a[2]);
+            restored++;
+        }
+    }
+    return restored;
+}
+
+void Store_Save_Config(int threshold_index, int threshold_rule) {
+    config_index = (uint8_t)threshold_index;
+    config_rule = (uint8_t)threshold_rule;
+    pending |= 1 << STORE_CONFIG;
+}
+
+void Store_Save_Cache(void) {
+    pending |= 1 << STORE_CACHE;
+}
+
+// Fills record[] with a new record of 'kind' from the current state and picks its slot.
+static void Build_Record(int kind) {
+    uint32_t *p = record + 2;
+    if (kind == STORE_CONFIG) {
+        *p++ = config_index | (uint32_t)config_rule << 8 | (uint32_t)alert_rule_count << 16;
+        for (int i = 0; i < ALERT_MAX_RULES; i++, p += 4) {
+            const Alert_Rule *r = &alert_rules[i];
+            int used = i < alert_rule_count;
+            p[0] = used ? (uint32_t)(r->type | r->asset << 8 | r->priority << 16) : 0;
+            p[1] = used ? (uint32_t)r->level : 0;
+            p[2] = used ? (uint32_t)r->hysteresis : 0;
+            p[3] = used ? r->window_ms : 0;
+        }
+    } else {
+        for (int id = 0; id < ASSET_MAX; id++) {
+            *p++ = (uint32_t)asset_price[id];
+            *p++ = (uint16_t)asset_change[id] | (uint32_t)asset_flags[id] << 16;
+            *p++ = asset_timestamp[id];
+        }
+    }
+    record[0] = STORE_MAGIC | STORE_VERSION << 16 | (uint32_t)kind << 24;
+    record[1] = next_seq[kind]++;
+    record_len = (uint32_t)(p - record);
+    record[1] |= (uint32_t)Record_Crc(record_len) << 16;
+    record_block = (uint8_t)(region_block[kind] + next_slot[kind] * region_slot[kind]);
+    next_slot[kind] = (uint8_t)((next_slot[kind] + 1) % region_slots[kind]);
+    record_sent = 0;
+}
+
+void Store_Job(void) {
+    if (!enabled)
+        return;
+    if (record_sent == record_len) {
+        if (!pending)
+            return;
+        int kind = (pending & (1 << STORE_CONFIG)) ? STORE_CONFIG : STORE_CACHE;
+        pending &= (uint8_t)~(1 << kind);
+        Build_Record(kind);       // Snapshot now: later changes go into the next record.
+    }
+    if (EEPROM->EEDONE & 0x01)
+        return;                   // WORKING: the previous word is still being programmed.
+    if ((record_sent & (BLOCK_WORDS - 1)) == 0) {
+        EEPROM->EEBLOCK = record_block + record_sent / BLOCK_WORDS;
+        EEPROM->EEOFFSET = 0;
+    }
+    EEPROM_WRITE_INC(record[record_sent++]);
+    store_writes++;
+}
+
+int Store_Busy(void) {
+    return pending != 0 || record_sent < record_len;
+}
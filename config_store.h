@@ -0,0 +1,49 @@
+//config_store.h
+// Settings and the warm-start price cache, kept in the TM4C123's 2 KB on-chip EEPROM (32 blocks of 16 words).
+//
+// Each kind of record has its own region, split into equal slots that are written in turn, so the wear is
+// spread over the whole region and the previous record stays intact until a newer one is complete. A power
+// cut in the middle of a write leaves a slot that fails its CRC; loading picks the valid slot with the
+// newest sequence number.
+//
+// Slot layout (32-bit words): [0] STORE_MAGIC (bits 0-15), STORE_VERSION (bits 16-23), kind (bits 24-31);
+// [1] sequence number (bits 0-15), CRC-16/CCITT-FALSE over the record with this field as 0 (bits 16-31);
+// [2..] payload.
+//   STORE_CONFIG payload: threshold index (bits 0-7), threshold rule (bits 8-15), rule count (bits 16-23);
+//                         then per rule: type | asset << 8 | priority << 16, level, hysteresis, window_ms.
+//   STORE_CACHE payload:  per asset id: price (cents), change (bp, bits 0-15) | flags (bits 16-23), timestamp.
+// Records with another STORE_VERSION are ignored (defaults are used and the layout is rewritten).
+#ifndef CONFIG_STORE_H            // Prevent multiple inclusions
+#define CONFIG_STORE_H
+
+#include "tracker.h"              // uint32_t
+#include "alert.h"                // ALERT_MAX_RULES
+#include "asset_table.h"          // ASSET_MAX
+
+#define STORE_MAGIC   0x4B54      // "TK"
+#define STORE_VERSION 1           // Bumped whenever a payload layout changes
+
+// Record kinds and their regions: first block, blocks per slot, slots.
+#define STORE_CONFIG  0           // Threshold and alert rules: written when the picker closes
+#define STORE_CACHE   1           // Last prices: written at most every CACHE_SAVE_MS (main.c)
+#define STORE_CONFIG_BLOCK 0
+#define STORE_CONFIG_SLOT  8      // 128 words: 3 + 4 per rule
+#define STORE_CONFIG_SLOTS 2
+#define STORE_CACHE_BLOCK  16
+#define STORE_CACHE_SLOT   2      // 32 words: 2 + 3 per asset
+#define STORE_CACHE_SLOTS  8
+
+extern uint32_t store_writes;     // Words programmed since Store_Init
+extern uint32_t store_errors;     // Load failures (CRC, magic or version) plus EEPROM errors at start-up
+
+int Store_Init(void);             // Enable the EEPROM module; returns 0 if it reports an error (store disabled)
+int Store_Load_Config(int *threshold_index, int *threshold_rule);
+// Re-create the saved alert rules (Alert_Add, in their saved order) and return the picker state.
+// Returns 0, with nothing changed, if there is no valid config record.
+int Store_Load_Cache(void);       // Restore the saved prices (Asset_Restore); returns the number of assets
+void Store_Save_Config(int threshold_index, int threshold_rule);  // Queue a config record with the current rules
+void Store_Save_Cache(void);      // Queue a cache record with the current prices
+void Store_Job(void);             // Scheduler job: program the next queued word once the EEPROM is idle
+int Store_Busy(void);             // 1 while a record is being written or waiting to be
+
+#endif // CONFIG_STORE_H
@@ -0,0 +1,225 @@
+//history.c
+
+#include "history.h"
+
+#define TICK_MASK   (HISTORY_TICK_WORDS - 1)
+#define WINDOW_MASK (HISTORY_WINDOW - 1)
+#define MINUTE_MS   60000U
+#define HOUR_MS     3600000U
+
+History history[ASSET_MAX];
+
+typedef char history_sizes_ok[((HISTORY_TICK_WORDS & TICK_MASK) == 0 && (HISTORY_WINDOW & WINDOW_MASK) == 0 &&
+                               HISTORY_WINDOW <= 255 && HISTORY_MINUTES <= 255 && HISTORY_HOURS <= 255) ? 1 : -1];
+typedef char history_fits_ram[(sizeof(history) <= 8192) ? 1 : -1];  // Keep the whole store within 8 KB of SRAM.
+
+const unsigned char history_glyphs[8][8] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+};
+
+// Drops the oldest tick from the ring.
+static void Tick_Drop(History *h) {
+    h->tail += h->words[h->tail & TICK_MASK] == HISTORY_ESCAPE ? 4 : 1;
+    h->ticks--;
+}
+
+// Appends the change from the previous tick, dropping the oldest ticks until it fits.
+static void Tick_Push(History *h, int32_t delta) {
+    int size = (delta >= -32767 && delta <= 32767) ? 1 : 4;
+    while (HISTORY_TICK_WORDS - (uint16_t)(h->head - h->tail) < size)
+        Tick_Drop(h);
+    if (size == 1) {
+        h->words[h->head++ & TICK_MASK] = (uint16_t)delta;
+    } else {
+        h->words[h->head++ & TICK_MASK] = HISTORY_ESCAPE;
+        h->words[h->head++ & TICK_MASK] = (uint16_t)((uint32_t)delta >> 16);
+        h->words[h->head++ & TICK_MASK] = (uint16_t)delta;
+        h->words[h->head++ & TICK_MASK] = HISTORY_ESCAPE;
+    }
+    h->ticks++;
+}
+
+// Pushes 'cents' onto the back of a monotonic deque (is_max: prices decreasing from the front, otherwise
+// increasing), after retiring the front entry if it has left the window. Amortized O(1): every price is
+// pushed and popped at most once.
+static void Deque_Push(int32_t *price, uint16_t *seq, uint8_t *head, uint8_t *count, int32_t cents,
+                       uint16_t now_seq, int is_max) {
+    if (*count && (uint16_t)(now_seq - seq[*head & WINDOW_MASK]) >= HISTORY_WINDOW) {
+        *head = (uint8_t)((*head + 1) & WINDOW_MASK);
+        (*count)--;
+    }
+    while (*count) {
+        int32_t back = price[(*head + *count - 1) & WINDOW_MASK];
+        if (is_max ? back > cents : back < cents)
+            break;
+        (*count)--;               // Can never be the extreme again: the new price outlives it.
+    }
+    price[(*head + *count) & WINDOW_MASK] = cents;
+    seq[(*head + *count) & WINDOW_MASK] = now_seq;
+    (*count)++;
+}
+
+// Records the close of each period that ended since '*start', up to the tier size.
+static void Tier_Close(int32_t *ring, int size, uint8_t *head, uint8_t *count, uint32_t *start,
+                       uint32_t period, int32_t close, uint32_t now_ms) {
+    for (int n = 0; n < size && now_ms - *start >= period; n++) {
+        ring[*head] = close;
+        *head = (uint8_t)((*head + 1) % size);
+        if (*count < size)
+            (*count)++;
+        *start += period;
+    }
+    if (now_ms - *start >= period)
+        *start = now_ms;          // Gap longer than the whole tier: restart the period here.
+}
+
+void History_Add(int asset, int32_t cents, uint32_t now_ms) {
+    if (asset < 0 || asset >= ASSET_MAX)
+        return;
+    History *h = &history[asset];
+    if (h->ticks == 0 && h->seq == 0) {
+        h->last = cents;          // First price: no change, no return.
+        h->ema = (int64_t)cents << 16;
+        h->minute_start = h->hour_start = now_ms;
+    } else {
+        Tier_Close(h->minute, HISTORY_MINUTES, &h->minute_head, &h->minute_count, &h->minute_start,
+                   MINUTE_MS, h->last, now_ms);
+        Tier_Close(h->hour, HISTORY_HOURS, &h->hour_head, &h->hour_count, &h->hour_start,
+                   HOUR_MS, h->last, now_ms);
+        // Return in bp, clamped to int16; the oldest return leaves the sums once the window is full.
+        int64_t r = h->last > 0 ? ((int64_t)cents - h->last) * 10000 / h->last : 0;
+        if (r > 32767)
+            r = 32767;
+        if (r < -32767)
+            r = -32767;
+        int slot = h->seq & WINDOW_MASK;
+        if (h->ret_count == HISTORY_WINDOW) {
+            h->ret_sum -= h->ret[slot];
+            h->ret_sq -= (int32_t)h->ret[slot] * h->ret[slot];
+        } else {
+            h->ret_count++;
+        }
+        h->ret[slot] = (int16_t)r;
+        h->ret_sum += (int32_t)r;
+        h->ret_sq += r * r;
+        h->ema += (((int64_t)cents << 16) - h->ema) >> HISTORY_EMA_SHIFT;
+    }
+    Tick_Push(h, (int32_t)((int64_t)cents - h->last));
+    h->seq++;
+    Deque_Push(h->max_price, h->max_seq, &h->max_head, &h->max_count, cents, h->seq, 1);
+    Deque_Push(h->min_price, h->min_seq, &h->min_head, &h->min_count, cents, h->seq, 0);
+    h->last = cents;
+    h->last_ms = now_ms;
+}
+
+int History_Count(int asset, int tier) {
+    if (asset < 0 || asset >= ASSET_MAX)
+        return 0;
+    if (tier == HISTORY_MINUTE)
+        return history[asset].minute_count;
+    if (tier == HISTORY_HOUR)
+        return history[asset].hour_count;
+    return history[asset].ticks;
+}
+
+int History_Recent(int asset, int tier, int32_t *out, int n) {
+    int count = History_Count(asset, tier);
+    if (n > count)
+        n = count;
+    if (n <= 0)
+        return 0;
+    History *h = &history[asset];
+    if (tier == HISTORY_TICKS) {
+        // Walk back from the newest price, undoing one change per tick.
+        int32_t price = h->last;
+        uint16_t pos = h->head;
+        for (int i = n - 1; i >= 0; i--) {
+            out[i] = price;
+            uint16_t word = h->words[--pos & TICK_MASK];
+            if (word == HISTORY_ESCAPE) {
+                uint32_t low = h->words[--pos & TICK_MASK];
+                uint32_t high = h->words[--pos & TICK_MASK];
+                pos--;            // Opening escape word.
+                price -= (int32_t)(high << 16 | low);
+            } else {
+                price -= (int16_t)word;
+            }
+        }
+    } else {
+        const int32_t *ring = tier == HISTORY_MINUTE ? h->minute : h->hour;
+        int size = tier == HISTORY_MINUTE ? HISTORY_MINUTES : HISTORY_HOURS;
+        int head = tier == HISTORY_MINUTE ? h->minute_head : h->hour_head;
+        for (int i = 0; i < n; i++)
+            out[i] = ring[(head - n + i + size) % size];
+    }
+    return n;
+}
+
+int32_t History_Min(int asset) {
+    if (asset < 0 || asset >= ASSET_MAX || history[asset].min_count == 0)
+        return 0;
+    return history[asset].min_price[history[asset].min_head & WINDOW_MASK];
+}
+
+int32_t History_Max(int asset) {
+    if (asset < 0 || asset >= ASSET_MAX || history[asset].max_count == 0)
+        return 0;
+    return history[asset].max_price[history[asset].max_head & WINDOW_MASK];
+}
+
+int32_t History_EMA(int asset) {
+    if (asset < 0 || asset >= ASSET_MAX)
+        return 0;
+    return (int32_t)((history[asset].ema + 0x8000) >> 16);  // Round to the nearest cent.
+}
+
+int32_t History_Volatility(int asset) {
+    if (asset < 0 || asset >= ASSET_MAX || history[asset].ret_count < 2)
+        return 0;
+    const History *h = &history[asset];
+    int64_t n = h->ret_count;
+    uint64_t var = (uint64_t)(n * h->ret_sq - (int64_t)h->ret_sum * h->ret_sum) / (uint64_t)(n * n);
+    // Integer square root, one result bit per step (only run when the value is read).
+    uint64_t root = 0, bit = (uint64_t)1 << 62;
+    while (bit > var)
+        bit >>= 2;
+    while (bit) {
+        if (var >= root + bit) {
+            var -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (int32_t)root;
+}
+
+int History_Sparkline(int asset, int tier, char *cells) {
+    int32_t values[HISTORY_SPARK_COLS];
+    int n = History_Recent(asset, tier, values, HISTORY_SPARK_COLS);
+    int32_t low = 0, high = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || values[i] < low)
+            low = values[i];
+        if (i == 0 || values[i] > high)
+            high = values[i];
+    }
+    for (int col = 0; col < HISTORY_SPARK_COLS; col++) {
+        int i = col - (HISTORY_SPARK_COLS - n);  // Newest value in the rightmost column.
+        if (i < 0) {
+            cells[col] = ' ';
+            continue;
+        }
+        int bar = high > low ? (int)((int64_t)(values[i] - low) * 7 / (high - low)) : 3;  // Flat: mid height.
+        cells[col] = (char)(HISTORY_GLYPH_CODE + bar);
+    }
+    return n;
+}
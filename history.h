@@ -0,0 +1,68 @@
+//history.h
+#ifndef HISTORY_H                 // Prevent multiple inclusions
+#define HISTORY_H
+
+#include "tracker.h"              // int32_t, uint32_t
+#include "asset_table.h"          // ASSET_MAX
+
+// Sizes (all storage is the static history[] table below, so RAM use is fixed at compile time):
+#define HISTORY_TICK_WORDS 128    // Tick ring, in 16-bit words (a tick costs 1 word, or 4 for a big jump)
+#define HISTORY_WINDOW     16     // Ticks in the rolling min/max/volatility window (power of two)
+#define HISTORY_MINUTES    32     // Minute closes kept
+#define HISTORY_HOURS      24     // Hour closes kept
+#define HISTORY_EMA_SHIFT  4      // EMA weight of a new tick: 1/16
+#define HISTORY_SPARK_COLS 8      // Width of the LCD sparkline in characters
+#define HISTORY_GLYPH_CODE 0x08   // Character code of the 1-row bar; 0x08-0x0F show CGRAM slots 0-7
+#define HISTORY_ESCAPE 0x8000     // Tick word marking a 32-bit change (see History)
+
+// Tiers for History_Recent / History_Sparkline:
+#define HISTORY_TICKS  0          // Every received price
+#define HISTORY_MINUTE 1          // Last price of each minute
+#define HISTORY_HOUR   2          // Last price of each hour
+
+typedef struct {
+    // Tick ring: each tick is the change from the previous tick in cents, as one int16 word; a change
+    // outside +/-32767 is written as HISTORY_ESCAPE, high word, low word, HISTORY_ESCAPE so the ring can
+    // be walked from either end.
+    uint16_t words[HISTORY_TICK_WORDS];
+    uint16_t head, tail;          // Free-running word indices (newest tick ends at head)
+    uint16_t ticks;               // Ticks held in the ring
+    uint16_t seq;                 // Ticks received (wraps; only differences are used)
+    int32_t last;                 // Newest price in cents
+    uint32_t last_ms;             // SysTick_Millis() of the newest price
+    // Rolling window over the last HISTORY_WINDOW ticks: monotonic deques for min and max (prices in
+    // order of arrival, each deque keeps only the ones that can still become the extreme).
+    int32_t max_price[HISTORY_WINDOW], min_price[HISTORY_WINDOW];
+    uint16_t max_seq[HISTORY_WINDOW], min_seq[HISTORY_WINDOW];
+    uint8_t max_head, max_count, min_head, min_count;
+    // Tick-to-tick returns in bp over the same window, with running sums for the volatility.
+    int16_t ret[HISTORY_WINDOW];
+    uint8_t ret_count;
+    int32_t ret_sum;
+    int64_t ret_sq;
+    int64_t ema;                  // Exponential moving average in cents, Q16 fixed point
+    // Downsampled tiers: rings of closing prices.
+    int32_t minute[HISTORY_MINUTES];
+    int32_t hour[HISTORY_HOURS];
+    uint8_t minute_head, minute_count, hour_head, hour_count;
+    uint32_t minute_start, hour_start;  // SysTick_Millis() at which the current minute / hour began
+} History;
+
+extern History history[ASSET_MAX];
+extern const unsigned char history_glyphs[8][8];  // CGRAM bitmaps: slot n is a bar n + 1 rows high
+
+void History_Add(int asset, int32_t cents, uint32_t now_ms);
+// Record a price (ignores ids >= ASSET_MAX). Constant time except after a gap of more than a minute,
+// when each missed minute/hour is filled with the previous close (bounded by the tier sizes).
+int History_Count(int asset, int tier);  // Values held in a tier (0 before the first price)
+int History_Recent(int asset, int tier, int32_t *out, int n);
+// Copy up to the n newest values of a tier into out[], oldest first. Returns the number copied.
+int32_t History_Min(int asset);          // Lowest price of the last HISTORY_WINDOW ticks
+int32_t History_Max(int asset);          // Highest price of the last HISTORY_WINDOW ticks
+int32_t History_EMA(int asset);          // Exponential moving average of the ticks, in cents
+int32_t History_Volatility(int asset);   // Standard deviation of the tick-to-tick returns in the window (bp)
+int History_Sparkline(int asset, int tier, char *cells);
+// Fill cells[0..HISTORY_SPARK_COLS-1] with bar characters (see HISTORY_GLYPH_CODE) for the newest values
+// of a tier, scaled between their low and high. Columns without data are spaces. Returns the values drawn.
+
+#endif // HISTORY_H
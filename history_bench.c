@@ -0,0 +1,224 @@
+//history_bench.c
+// Host test and benchmark for the price history in history.c: feeds random price series (with jumps that
+// need the escaped tick encoding and gaps that skip minutes and hours) through History_Add, checks the
+// incremental statistics against brute force over the same prices, and measures the update cost per
+// tick. Build:
+//   cc -O2 -DTRACKER_HOST -o history_bench history_bench.c history.c -lm
+// Usage:
+//   history_bench [-n ticks] [-s seed]   Exits non-zero if any check fails
+//
+// Checks, after every tick:
+//   minmax   History_Min / History_Max equal the lowest / highest of the last HISTORY_WINDOW prices
+//   ticks    History_Recent(HISTORY_TICKS) gives back exactly the newest prices, as many as the ring holds
+//   ema      History_EMA is within a cent of a floating-point EMA with weight 1 / 2^HISTORY_EMA_SHIFT
+//   vol      History_Volatility is within a basis point of the standard deviation of the window's returns
+
+#include "history.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERIES_MAX  (HISTORY_TICK_WORDS + HISTORY_WINDOW)  // Newest prices kept for the brute-force checks
+#define BENCH_TICKS 1000000
+#define ASSETS      4
+
+static int failures = 0;
+static uint32_t checked[4];       // minmax, ticks, ema, vol
+
+static double Now_Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void Fail(const char *check, int asset, uint32_t tick, long got, long want) {
+    if (failures++ < 10)
+        printf("FAIL %-8s asset %d tick %lu: %ld, expected %ld\n", check, asset, (unsigned long)tick, got, want);
+}
+
+// Brute-force state per asset: the newest prices (a plain ring) and the reference EMA.
+typedef struct {
+    int32_t price[SERIES_MAX];
+    uint32_t count;               // Prices received
+    double ema;
+} Series;
+
+static int32_t Series_At(const Series *s, uint32_t back) {  // back = 0: newest
+    return s->price[(s->count - 1 - back) % SERIES_MAX];
+}
+
+// Next price: a random walk with jumps of more than $327.67 now and then (escaped ticks in the ring).
+static int32_t Next_Price(int32_t cents) {
+    int64_t p = cents;
+    int r = rand() % 100;
+    if (r < 3)
+        p += (rand() % 2 ? 1 : -1) * (int64_t)(40000 + rand() % 2000000);
+    else
+        p += (int64_t)(rand() % 20001) - 10000;
+    if (p < 1)
+        p = 1 + rand() % 1000;
+    if (p > 2000000000)
+        p = 2000000000 - rand() % 1000000;
+    return (int32_t)p;
+}
+
+static void Check_Tick(int asset, const Series *s) {
+    uint32_t window = s->count < HISTORY_WINDOW ? s->count : HISTORY_WINDOW;
+    int32_t low = Series_At(s, 0), high = low;
+    for (uint32_t i = 1; i < window; i++) {
+        int32_t p = Series_At(s, i);
+        if (p < low)
+            low = p;
+        if (p > high)
+            high = p;
+    }
+    if (History_Min(asset) != low)
+        Fail("minmax", asset, s->count, (long)History_Min(asset), (long)low);
+    if (History_Max(asset) != high)
+        Fail("minmax", asset, s->count, (long)History_Max(asset), (long)high);
+    checked[0]++;
+
+    static int32_t recent[HISTORY_TICK_WORDS];
+    int n = History_Recent(asset, HISTORY_TICKS, recent, HISTORY_TICK_WORDS);
+    uint32_t least = s->count < HISTORY_TICK_WORDS / 4 ? s->count : HISTORY_TICK_WORDS / 4;  // All escaped
+    if ((uint32_t)n < least || (uint32_t)n > s->count)
+        Fail("ticks", asset, s->count, n, (long)least);
+    for (int i = 0; i < n && (uint32_t)n <= s->count; i++) {
+        if (recent[i] != Series_At(s, (uint32_t)(n - 1 - i))) {
+            Fail("ticks", asset, s->count, (long)recent[i], (long)Series_At(s, (uint32_t)(n - 1 - i)));
+            break;
+        }
+    }
+    checked[1]++;
+
+    if (fabs(History_EMA(asset) - s->ema) > 1.0)
+        Fail("ema", asset, s->count, (long)History_EMA(asset), lround(s->ema));
+    checked[2]++;
+
+    // Population standard deviation of the clamped tick-to-tick returns in the window.
+    uint32_t returns = s->count - 1 < HISTORY_WINDOW ? s->count - 1 : HISTORY_WINDOW;
+    if (returns >= 2) {
+        double sum = 0, sq = 0;
+        for (uint32_t i = 0; i < returns; i++) {
+            int32_t to = Series_At(s, i), from = Series_At(s, i + 1);
+            int64_t r = ((int64_t)to - from) * 10000 / from;
+            r = r > 32767 ? 32767 : r < -32767 ? -32767 : r;
+            sum += (double)r;
+            sq += (double)r * (double)r;
+        }
+        double sd = sqrt(sq / returns - (sum / returns) * (sum / returns));
+        if (fabs(History_Volatility(asset) - sd) > 1.0)
+            Fail("vol", asset, s->count, (long)History_Volatility(asset), lround(sd));
+        checked[3]++;
+    }
+}
+
+static void Check_Series(uint32_t count) {
+    static Series series[ASSETS];
+    int32_t cents[ASSETS];
+    uint32_t now = 0;
+    for (int a = 0; a < ASSETS; a++)
+        cents[a] = 100 + rand() % 10000000;
+    for (uint32_t t = 0; t < count; t++) {
+        int a = rand() % ASSETS;
+        Series *s = &series[a];
+        now += rand() % 50 == 0 ? (uint32_t)rand() % 90000000 : (uint32_t)rand() % 30000;  // Gaps up to a day
+        cents[a] = Next_Price(cents[a]);
+        History_Add(a, cents[a], now);
+        s->price[s->count % SERIES_MAX] = cents[a];
+        s->ema = s->count == 0 ? cents[a] : s->ema + (cents[a] - s->ema) / (1 << HISTORY_EMA_SHIFT);
+        s->count++;
+        Check_Tick(a, s);
+    }
+    printf("checked %lu ticks on %d assets: min/max %lu, tick ring %lu, EMA %lu, volatility %lu\n",
+           (unsigned long)count, ASSETS, (unsigned long)checked[0], (unsigned long)checked[1],
+           (unsigned long)checked[2], (unsigned long)checked[3]);
+}
+
+// Min, max and volatility recomputed over the window on every tick: what the deques and running sums save.
+static volatile int64_t sink;
+
+static void Brute_Window(const int32_t *window) {
+    int32_t low = window[0], high = window[0];
+    int64_t sum = 0, sq = 0;
+    for (int i = 1; i < HISTORY_WINDOW; i++) {
+        if (window[i] < low)
+            low = window[i];
+        if (window[i] > high)
+            high = window[i];
+        int64_t r = ((int64_t)window[i] - window[i - 1]) * 10000 / window[i - 1];
+        sum += r;
+        sq += r * r;
+    }
+    sink += low + high + sum + sq;
+}
+
+static void Benchmark(void) {
+    static int32_t prices[BENCH_TICKS];
+    static uint32_t times[BENCH_TICKS];
+    int32_t window[HISTORY_WINDOW];
+    int32_t cents = 6500000;
+    uint32_t now = 0;
+    for (int i = 0; i < BENCH_TICKS; i++) {
+        prices[i] = cents = Next_Price(cents);
+        times[i] = now += 20000;  // One price every 20 s, as fetched
+    }
+    memset(history, 0, sizeof(history));
+    for (int i = 0; i < HISTORY_WINDOW; i++)
+        window[i] = prices[0];
+
+    double t0 = Now_Seconds();
+    for (int i = 0; i < BENCH_TICKS; i++)
+        History_Add(0, prices[i], times[i]);
+    double t1 = Now_Seconds();
+    for (int i = 0; i < BENCH_TICKS; i++) {
+        window[i & (HISTORY_WINDOW - 1)] = prices[i];
+        Brute_Window(window);
+    }
+    double t2 = Now_Seconds();
+    for (int i = 0; i < BENCH_TICKS; i++)
+        sink += History_Min(0) + History_Max(0) + History_EMA(0) + History_Volatility(0);
+    double t3 = Now_Seconds();
+
+    // Worst case: the first tick after a day without prices fills every minute and hour slot.
+    double worst = 0;
+    for (int i = 0; i < 1000; i++) {
+        now += 86400000;
+        double w0 = Now_Seconds();
+        History_Add(0, prices[i], now);
+        double w1 = Now_Seconds();
+        if (w1 - w0 > worst)
+            worst = w1 - w0;
+    }
+
+    printf("\nupdate cost (host, -O2)                        ns/tick\n");
+    printf("%-46s %7.1f\n", "History_Add", (t1 - t0) * 1e9 / BENCH_TICKS);
+    printf("%-46s %7.1f\n", "  worst case, after a day-long gap", worst * 1e9);
+    printf("%-46s %7.1f\n", "brute-force window min/max/returns", (t2 - t1) * 1e9 / BENCH_TICKS);
+    printf("%-46s %7.1f\n", "Min + Max + EMA + Volatility reads", (t3 - t2) * 1e9 / BENCH_TICKS);
+    printf("\nmemory: %u bytes per asset, %u bytes for %d assets (fixed at compile time)\n",
+           (unsigned)sizeof(History), (unsigned)sizeof(history), ASSET_MAX);
+}
+
+int main(int argc, char **argv) {
+    uint32_t count = 2000000;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            count = (uint32_t)strtoul(optarg, 0, 10);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    srand(seed);
+    Check_Series(count);
+    Benchmark();
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
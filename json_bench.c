@@ -0,0 +1,159 @@
+//json_bench.c
+// Host benchmark for the streaming JSON filter in json_stream.c on saved API responses: throughput, how
+// much of the body is read before every field has been found (where the sketches stop reading), and the
+// peak memory of the parse, next to what http.getString() plus StaticJsonDocument<1024> needed. Build:
+//   cc -O2 -o json_bench json_bench.c json_stream.c
+// Usage:
+//   json_bench [-r rounds] [file [path...]]   Exits non-zero if the file fails to parse or a path is missing
+// Without arguments it reads testdata/coins_bitcoin.json next to the binary (a /coins/bitcoin?localization=false
+// &tickers=false&market_data=true response) with the two fields Coin_tracker.ino reads from it.
+
+#include "json_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STACK_PROBE   8192        // Stack area painted to find how deep Json_Stream_Feed goes
+#define STACK_PAINT   0xCD
+#define CHUNK_SIZE    64          // Socket read buffer in the sketches
+#define OLD_DOC_SIZE  1024        // StaticJsonDocument<1024> in the original sketches
+
+static const char *const default_paths[] = {
+    "market_data.current_price.usd",
+    "market_data.price_change_percentage_24h",
+};
+
+static char values[JSON_MAX_FILTERS][JSON_VALUE_MAX];
+
+static double Now_Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void On_Value(void *ctx, int filter, const char *text) {
+    (void)ctx;
+    strncpy(values[filter], text, JSON_VALUE_MAX - 1);
+}
+
+// Fills the stack just below the caller's frame with a pattern. Stack_Used, called later from the same
+// function, finds how much of it the calls in between overwrote (the stack grows down on every host we
+// build on, so the untouched part is at the low end).
+static __attribute__((noinline)) int Stack_Paint(void) {
+    volatile uint8_t area[STACK_PROBE];
+    for (int i = 0; i < STACK_PROBE; i++)
+        area[i] = STACK_PAINT;
+    return area[0];
+}
+
+static __attribute__((noinline)) int Count_Painted(volatile uint8_t *area) {
+    int i = 0;
+    while (i < STACK_PROBE && area[i] == STACK_PAINT)
+        i++;
+    return i;
+}
+
+static __attribute__((noinline)) int Stack_Used(void) {
+    volatile uint8_t area[STACK_PROBE];
+    return STACK_PROBE - Count_Painted(area);
+}
+
+// One pass over the whole body; returns the last Json_Stream_Feed result. 'stop' is set to the bytes
+// read when every path had been found (0 if never).
+static __attribute__((noinline)) int Parse(Json_Stream *js, const char *const *paths, int count,
+                                          const char *body, long len, long *stop) {
+    int result = JSON_MORE;
+    *stop = 0;
+    Json_Stream_Init(js, paths, (uint8_t)count, On_Value, 0);
+    for (long i = 0; i < len && result == JSON_MORE; i++) {
+        result = Json_Stream_Feed(js, body[i]);
+        if (!*stop && Json_Stream_All_Found(js))
+            *stop = i + 1;
+    }
+    return result;
+}
+
+static char *Load(const char *name, long *len) {
+    FILE *f = fopen(name, "rb");
+    char *body = 0;
+    if (!f)
+        return 0;
+    if (fseek(f, 0, SEEK_END) == 0 && (*len = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0 &&
+        (body = malloc((size_t)*len)) != 0 && fread(body, 1, (size_t)*len, f) != (size_t)*len) {
+        free(body);
+        body = 0;
+    }
+    fclose(f);
+    return body;
+}
+
+int main(int argc, char **argv) {
+    // Default: testdata next to the binary, so the benchmark runs from any directory.
+    char name_buf[160];
+    const char *slash = strrchr(argv[0], '/');
+    snprintf(name_buf, sizeof(name_buf), "%.*stestdata/coins_bitcoin.json", slash ? (int)(slash - argv[0] + 1) : 0,
+             argv[0]);
+    const char *name = name_buf;
+    const char *const *paths = default_paths;
+    int count = (int)(sizeof(default_paths) / sizeof(default_paths[0]));
+    int rounds = 200, opt, failed = 0;
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        if (opt == 'r')
+            rounds = atoi(optarg);
+        else
+            return 2;
+    }
+    if (optind < argc)
+        name = argv[optind++];
+    if (optind < argc) {
+        paths = (const char *const *)(argv + optind);
+        count = argc - optind;
+    }
+    if (count > JSON_MAX_FILTERS) {
+        fprintf(stderr, "at most %d paths\n", JSON_MAX_FILTERS);
+        return 2;
+    }
+    long len = 0, stop = 0;
+    char *body = Load(name, &len);
+    if (!body) {
+        fprintf(stderr, "cannot read %s\n", name);
+        return 2;
+    }
+
+    // Correctness and peak stack. The first pass also binds the library calls made on the way, so the
+    // dynamic linker's stack use stays out of the measured one.
+    Json_Stream js;
+    Parse(&js, paths, count, body, len, &stop);
+    Stack_Paint();
+    int result = Parse(&js, paths, count, body, len, &stop);
+    int stack = Stack_Used();
+    printf("%s: %ld bytes, %s\n", name, len, result == JSON_DONE ? "parsed" : result == JSON_ERROR ?
+           "PARSE ERROR" : "TRUNCATED");
+    failed |= result != JSON_DONE;
+    for (int i = 0; i < count; i++) {
+        int found = (js.found >> i) & 1;
+        printf("  %-48s %s\n", paths[i], found ? values[i] : "MISSING");
+        failed |= !found;
+    }
+
+    // Throughput over the whole body, as when a field is missing and the sketch reads to the end.
+    double t0 = Now_Seconds();
+    for (int r = 0; r < rounds; r++)
+        Parse(&js, paths, count, body, len, &stop);
+    double t1 = Now_Seconds();
+    double rate = (double)len * rounds / (t1 - t0);
+    printf("\nthroughput       %8.1f MB/s  (%.1f ns/byte, %.2f ms per response)\n", rate / 1e6, 1e9 / rate,
+           len / rate * 1e3);
+    if (stop)
+        printf("all found after  %8ld bytes  (%.0f %% of the body; the sketches stop reading there)\n", stop,
+               100.0 * stop / len);
+
+    printf("\npeak memory      %8d bytes  (Json_Stream %d + %d-byte read buffer + about %d of stack)\n",
+           (int)sizeof(Json_Stream) + CHUNK_SIZE + stack, (int)sizeof(Json_Stream), CHUNK_SIZE, stack);
+    printf("getString() path %8ld bytes  (at least: the whole body as a String + StaticJsonDocument<%d>)\n",
+           len + OLD_DOC_SIZE, OLD_DOC_SIZE);
+    free(body);
+    return failed;
+}
@@ -0,0 +1,219 @@
+//json_stream.c
+
+#include "json_stream.h"
+
+// Tokenizer states.
+#define S_VALUE      0            // Expecting a value
+#define S_KEY_OR_END 1            // Just inside '{' or after ',' in an object: expecting a key or '}'
+#define S_KEY        2            // Inside a key string
+#define S_KEY_ESC    3            // After '\' inside a key
+#define S_COLON      4            // Expecting ':' after a key
+#define S_AFTER      5            // After a value: expecting ',' or a closing bracket
+#define S_STRING     6            // Inside a string value
+#define S_STRING_ESC 7            // After '\' inside a string value
+#define S_PRIMITIVE  8            // Inside a number, true, false or null
+#define S_DONE       9            // Top-level value complete
+#define S_ERROR      10           // Malformed input
+
+static int Is_Space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void Json_Stream_Init(Json_Stream *js, const char *const *paths, uint8_t path_count,
+                      Json_Value_Callback on_value, void *ctx) {
+    uint8_t *p = (uint8_t *)js;
+    for (uint32_t i = 0; i < sizeof(*js); i++)
+        p[i] = 0;
+    js->paths = paths;
+    js->path_count = path_count > JSON_MAX_FILTERS ? JSON_MAX_FILTERS : path_count;
+    js->on_value = on_value;
+    js->ctx = ctx;
+    js->state = S_VALUE;
+}
+
+int Json_Stream_All_Found(const Json_Stream *js) {
+    uint32_t all = js->path_count >= 32 ? 0xFFFFFFFFUL : (1UL << js->path_count) - 1;
+    return js->path_count > 0 && (js->found & all) == all;
+}
+
+// Compares the key just read with segment 'index' of filter path 'path'.
+// Returns 0 if it differs, 1 if it matches and more segments follow, 2 if it matches the last segment.
+static int Match_Segment(const Json_Stream *js, const char *path, int index) {
+    while (index > 0 && *path) {  // Skip to the requested segment.
+        if (*path++ == '.')
+            index--;
+    }
+    if (index > 0 || js->key_len >= JSON_KEY_MAX)
+        return 0;
+    for (uint8_t i = 0; i < js->key_len; i++, path++) {
+        if (*path != js->key[i])
+            return 0;
+    }
+    if (*path == '\0')
+        return 2;
+    return *path == '.' ? 1 : 0;
+}
+
+// Called when a key string ends: work out which filters the upcoming value belongs to.
+static void Key_Complete(Json_Stream *js) {
+    uint32_t candidates = js->depth <= JSON_MATCH_DEPTH ? js->match[js->depth] : 0;
+    js->child_match = 0;
+    js->leaf_match = 0;
+    for (uint8_t i = 0; candidates && i < js->path_count; i++) {
+        if (!(candidates & (1UL << i)))
+            continue;
+        int m = Match_Segment(js, js->paths[i], js->depth - 1);
+        if (m == 1)
+            js->child_match |= 1UL << i;
+        else if (m == 2)
+            js->leaf_match |= 1UL << i;
+    }
+}
+
+static void Emit_Value(Json_Stream *js) {
+    js->value[js->value_len] = '\0';
+    for (uint8_t i = 0; js->value_match && i < js->path_count; i++) {
+        if (js->value_match & (1UL << i)) {
+            js->found |= 1UL << i;
+            if (js->on_value)
+                js->on_value(js->ctx, i, js->value);
+        }
+    }
+}
+
+static void Append_Value(Json_Stream *js, char c) {
+    if (js->value_match && js->value_len < JSON_VALUE_MAX - 1)
+        js->value[js->value_len++] = c;
+}
+
+static int Push(Json_Stream *js, int is_array) {
+    if (js->depth >= JSON_MAX_NESTING)
+        return 0;
+    if (is_array)
+        js->arrays |= 1UL << js->depth;
+    else
+        js->arrays &= ~(1UL << js->depth);
+    js->depth++;
+    if (js->depth == 1)
+        js->match[1] = is_array ? 0 : (js->path_count >= 32 ? 0xFFFFFFFFUL : (1UL << js->path_count) - 1);  // Every path starts at the root object.
+    else if (js->depth <= JSON_MATCH_DEPTH)
+        js->match[js->depth] = is_array ? 0 : js->child_match;  // Array elements have no key to match.
+    return 1;
+}
+
+static int Top_Is_Array(const Json_Stream *js) {
+    return js->depth > 0 && (js->arrays & (1UL << (js->depth - 1)));
+}
+
+// Handles ',' and closing brackets after a value.
+static void After_Value(Json_Stream *js, char c) {
+    if (Is_Space(c))
+        return;
+    if (c == ',' && js->depth > 0) {
+        js->child_match = js->leaf_match = 0;
+        js->state = Top_Is_Array(js) ? S_VALUE : S_KEY_OR_END;
+    } else if ((c == '}' && js->depth > 0 && !Top_Is_Array(js)) || (c == ']' && Top_Is_Array(js))) {
+        js->depth--;
+        js->child_match = js->leaf_match = 0;
+        js->state = js->depth == 0 ? S_DONE : S_AFTER;
+    } else {
+        js->state = S_ERROR;
+    }
+}
+
+int Json_Stream_Feed(Json_Stream *js, char c) {
+    js->bytes++;
+    switch (js->state) {
+    case S_VALUE:
+        if (Is_Space(c))
+            break;
+        js->value_match = js->leaf_match;
+        js->value_len = 0;
+        if (c == '{' || c == '[') {
+            if (!Push(js, c == '['))
+                js->state = S_ERROR;
+            else
+                js->state = (c == '{') ? S_KEY_OR_END : S_VALUE;
+            js->child_match = js->leaf_match = 0;
+        } else if (c == ']' && Top_Is_Array(js)) {
+            After_Value(js, c);   // Empty array.
+        } else if (c == '"') {
+            js->state = S_STRING;
+        } else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+            Append_Value(js, c);
+            js->state = S_PRIMITIVE;
+        } else {
+            js->state = S_ERROR;
+        }
+        break;
+    case S_KEY_OR_END:
+        if (Is_Space(c))
+            break;
+        if (c == '"') {
+            js->key_len = 0;
+            js->state = S_KEY;
+        } else if (c == '}') {
+            After_Value(js, c);   // Empty object.
+        } else {
+            js->state = S_ERROR;
+        }
+        break;
+    case S_KEY:
+        if (c == '\\') {
+            js->state = S_KEY_ESC;
+            break;
+        }
+        if (c == '"') {
+            Key_Complete(js);
+            js->state = S_COLON;
+            break;
+        }
+        /* fall through */
+    case S_KEY_ESC:
+        if (js->key_len < JSON_KEY_MAX)
+            js->key[js->key_len++] = c;  // Escapes are kept raw; filter keys never contain them.
+        if (js->state == S_KEY_ESC)
+            js->state = S_KEY;
+        break;
+    case S_COLON:
+        if (Is_Space(c))
+            break;
+        js->state = (c == ':') ? S_VALUE : S_ERROR;
+        break;
+    case S_STRING:
+        if (c == '\\') {
+            js->state = S_STRING_ESC;
+        } else if (c == '"') {
+            Emit_Value(js);
+            js->state = S_AFTER;
+        } else {
+            Append_Value(js, c);
+        }
+        break;
+    case S_STRING_ESC:
+        Append_Value(js, c);
+        js->state = S_STRING;
+        break;
+    case S_PRIMITIVE:
+        if (Is_Space(c) || c == ',' || c == '}' || c == ']') {
+            Emit_Value(js);
+            js->state = S_AFTER;
+            After_Value(js, c);   // The delimiter also ends the value.
+        } else {
+            Append_Value(js, c);
+        }
+        break;
+    case S_AFTER:
+        After_Value(js, c);
+        break;
+    case S_DONE:
+        if (!Is_Space(c))
+            js->state = S_ERROR;  // Trailing garbage after the document.
+        break;
+    default:
+        break;
+    }
+    if (js->state == S_ERROR)
+        return JSON_ERROR;
+    return js->state == S_DONE ? JSON_DONE : JSON_MORE;
+}
@@ -0,0 +1,59 @@
+//json_stream.h
+// Streaming, filtered JSON value extraction. The document is fed one byte at a time as it arrives from the
+// network, so memory use is this struct alone (about 160 bytes) no matter how large the payload is.
+// Only values whose key path matches one of the filter paths are reported; everything else is skipped.
+// Plain C with no platform dependencies, so it builds for the ESP32 and on a host.
+#ifndef JSON_STREAM_H             // Prevent multiple inclusions
+#define JSON_STREAM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {                      // The ESP32 sketches are C++
+#endif
+
+#define JSON_MAX_FILTERS 32       // Filter paths per stream (one bit each in a uint32_t)
+#define JSON_MATCH_DEPTH 8        // Deepest object level a filter path can reach
+#define JSON_MAX_NESTING 32       // Deepest nesting accepted at all (one bit each in a uint32_t)
+#define JSON_KEY_MAX     32       // Longest key that can match a filter segment
+#define JSON_VALUE_MAX   24       // Longest value text reported (longer values are truncated)
+
+// Called for every matched value. 'filter' indexes the path list; 'text' is the raw value text
+// (strings without quotes, numbers/true/false/null as written), null-terminated.
+typedef void (*Json_Value_Callback)(void *ctx, int filter, const char *text);
+
+typedef struct {
+    const char *const *paths;     // Filter paths, dot-separated object keys: "market_data.current_price.usd"
+    uint8_t path_count;
+    Json_Value_Callback on_value;
+    void *ctx;                    // Passed back to on_value
+    uint8_t state;                // Tokenizer state
+    uint8_t depth;                // Open containers
+    uint32_t arrays;              // Bit n set when the container at depth n+1 is an array
+    uint32_t match[JSON_MATCH_DEPTH + 1];  // Filters whose path matches the object open at each depth
+    uint32_t child_match;         // Filters expecting an object under the key just read
+    uint32_t leaf_match;          // Filters whose last segment is the key just read
+    uint32_t value_match;         // Filters the value being read belongs to
+    uint32_t found;               // Filters reported at least once
+    char key[JSON_KEY_MAX];
+    uint8_t key_len;              // JSON_KEY_MAX means the key overflowed (never matches)
+    char value[JSON_VALUE_MAX];
+    uint8_t value_len;
+    uint32_t bytes;               // Bytes consumed
+} Json_Stream;
+
+// Json_Stream_Feed results:
+#define JSON_MORE  0              // Keep feeding
+#define JSON_DONE  1              // The top-level value is complete
+#define JSON_ERROR -1             // Malformed input (or nesting deeper than JSON_MAX_NESTING)
+
+void Json_Stream_Init(Json_Stream *js, const char *const *paths, uint8_t path_count,
+                      Json_Value_Callback on_value, void *ctx);
+int Json_Stream_Feed(Json_Stream *js, char c);
+int Json_Stream_All_Found(const Json_Stream *js);  // 1 once every filter has been reported (stop reading early)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,128 @@
+//lcd_buffer.c
+
+#include "lcd_buffer.h"
+#include <stdarg.h>
+
+#define LCD_QUEUE_MASK (LCD_QUEUE_SIZE - 1)
+#define LCD_QUEUE_CMD  0x100      // Queue entry flag: send as a command instead of data
+#define LCD_ADDR_NONE  0xFF       // Panel cursor address unknown
+
+uint32_t lcd_frames = 0;
+uint32_t lcd_bytes_last_frame = 0;
+uint32_t lcd_bytes_total = 0;
+uint32_t lcd_queue_overflows = 0;
+
+static char back[LCD_ROWS][LCD_COLS];   // What the application wants on screen
+static char front[LCD_ROWS][LCD_COLS];  // What the panel shows once the queue has drained
+static uint16_t queue[LCD_QUEUE_SIZE];  // Pending panel writes (LCD_QUEUE_CMD | byte)
+static uint32_t queue_head = 0, queue_tail = 0;  // Free-running queue indices
+static unsigned char cursor = LCD_ADDR_NONE;     // DDRAM address the panel will write next
+
+// DDRAM address of a cell: row 0 starts at 0x00, row 1 at 0x40.
+static unsigned char Cell_Address(int col, int row) {
+    return (unsigned char)((row == 0 ? 0x00 : 0x40) + col);
+}
+
+static int Queue_Push(uint16_t entry) {
+    if (queue_head - queue_tail >= LCD_QUEUE_SIZE)
+        return 0;                 // Queue full.
+    queue[queue_head++ & LCD_QUEUE_MASK] = entry;
+    return 1;
+}
+
+void LCD_Buffer_Init(void) {
+    LCD_Clear();                  // Start from a known blank panel.
+    for (int row = 0; row < LCD_ROWS; row++)
+        for (int col = 0; col < LCD_COLS; col++)
+            back[row][col] = front[row][col] = ' ';
+    queue_head = queue_tail = 0;
+    cursor = 0x00;                // Clear display also homes the cursor.
+    lcd_bytes_total = 0;
+}
+
+void LCD_Load_Glyphs(const unsigned char glyphs[][8], int count) {
+    LCD_Send_Command(0x40);       // Set CGRAM address 0; data writes now fill the character bitmaps.
+    for (int i = 0; i < count && i < 8; i++)
+        for (int row = 0; row < 8; row++)
+            LCD_Send_Data(glyphs[i][row]);
+    LCD_Send_Command(0x80);       // Back to DDRAM address 0.
+    cursor = 0x00;
+}
+
+void LCD_Buffer_Clear(void) {
+    for (int row = 0; row < LCD_ROWS; row++)
+        for (int col = 0; col < LCD_COLS; col++)
+            back[row][col] = ' ';
+}
+
+void LCD_Put_At(unsigned char col, unsigned char row, char c) {
+    if (col < LCD_COLS && row < LCD_ROWS)
+        back[row][col] = c;
+}
+
+void LCD_Printf_At(unsigned char col, unsigned char row, const char *fmt, ...) {
+    char text[LCD_COLS + 1];      // One row at most; anything longer is clipped anyway.
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    for (int i = 0; text[i] && col + i < LCD_COLS; i++)
+        LCD_Put_At((unsigned char)(col + i), row, text[i]);
+}
+
+int LCD_Commit(void) {
+    int bytes = 0;
+    for (int row = 0; row < LCD_ROWS; row++) {
+        for (int col = 0; col < LCD_COLS; col++) {
+            if (back[row][col] == front[row][col])
+                continue;
+            unsigned char addr = Cell_Address(col, row);
+            if (cursor != addr) {
+                // Coalesce short jumps: rewriting one unchanged cell costs the same single byte as a
+                // "set DDRAM address" command, so only jump when the gap is two cells or more.
+                if (cursor != LCD_ADDR_NONE && addr == cursor + 1) {
+                    if (!Queue_Push((unsigned char)front[row][col - 1]))
+                        goto overflow;
+                    bytes++;
+                } else {
+                    if (!Queue_Push(LCD_QUEUE_CMD | 0x80 | addr))
+                        goto overflow;
+                    bytes++;
+                }
+            }
+            if (!Queue_Push((unsigned char)back[row][col]))
+                goto overflow;
+            bytes++;
+            front[row][col] = back[row][col];  // The panel will show this once the queue drains.
+            cursor = (unsigned char)(addr + 1);  // The HD44780 auto-increments after each data write.
+        }
+    }
+    if (bytes)
+        lcd_frames++;
+    lcd_bytes_last_frame = (uint32_t)bytes;
+    return bytes;
+
+overflow:
+    // The remaining differences stay in 'back' and are picked up by the next commit.
+    lcd_queue_overflows++;
+    cursor = LCD_ADDR_NONE;       // The entry that did not fit may have been a cursor move.
+    lcd_bytes_last_frame = (uint32_t)bytes;
+    return bytes;
+}
+
+int LCD_Flush_Step(void) {
+    if (queue_tail == queue_head)
+        return 0;                 // Nothing to send.
+    uint16_t entry = queue[queue_tail & LCD_QUEUE_MASK];
+    if (entry & LCD_QUEUE_CMD)
+        LCD_Send_Command((unsigned char)entry);
+    else
+        LCD_Send_Data((unsigned char)entry);
+    queue_tail++;
+    lcd_bytes_total++;
+    return 1;
+}
+
+int LCD_Flush_Pending(void) {
+    return (int)(queue_head - queue_tail);
+}
@@ -0,0 +1,34 @@
+//lcd_buffer.h
+#ifndef LCD_BUFFER_H              // Prevent multiple inclusions
+#define LCD_BUFFER_H
+
+#include "tracker.h"              // LCD_Send_Command / LCD_Send_Data
+
+#define LCD_COLS 16               // Characters per row on the 16x2 panel
+#define LCD_ROWS 2                // Number of rows on the panel
+#define LCD_QUEUE_SIZE 64         // Pending panel writes (a full-screen redraw needs at most 34)
+
+// Shadow framebuffer for the 16x2 LCD.
+// Drawing functions only touch a 32-cell back buffer. LCD_Commit() compares it with what the panel shows
+// and queues just the changed cells; LCD_Flush_Step() sends the queue to the panel one byte at a time,
+// so the main loop never waits for a whole redraw.
+
+// Instrumentation (updated by LCD_Commit and LCD_Flush_Step):
+extern uint32_t lcd_frames;           // Commits that changed at least one cell
+extern uint32_t lcd_bytes_last_frame; // Bytes (data + cursor commands) queued by the last commit
+extern uint32_t lcd_bytes_total;      // Bytes sent to the panel since LCD_Buffer_Init
+extern uint32_t lcd_queue_overflows;  // Commits that had to be truncated because the queue was full
+
+void LCD_Buffer_Init(void);       // Clear the panel once and reset both buffers to spaces
+void LCD_Load_Glyphs(const unsigned char glyphs[][8], int count);
+// Write 'count' (at most 8) custom 5x8 characters to CGRAM slots 0..count-1, directly (call at start-up,
+// before LCD_Buffer_Init). In the back buffer they are character codes 0x08-0x0F, so they never end a string.
+void LCD_Buffer_Clear(void);      // Fill the back buffer with spaces (the panel is not touched)
+void LCD_Put_At(unsigned char col, unsigned char row, char c);  // Store one raw character code in the back buffer
+void LCD_Printf_At(unsigned char col, unsigned char row, const char *fmt, ...);
+// Format text into the back buffer starting at (col, row); text past the end of the row is clipped.
+int LCD_Commit(void);             // Queue every cell that differs from the panel; returns bytes queued
+int LCD_Flush_Step(void);         // Send one queued byte to the panel; returns 1 if one was sent, 0 if idle
+int LCD_Flush_Pending(void);      // Number of queued bytes not yet sent
+
+#endif // LCD_BUFFER_H
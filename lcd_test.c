@@ -0,0 +1,226 @@
+//lcd_test.c
+// Host test for the shadow framebuffer in lcd_buffer.c: LCD_Clear / LCD_Send_Command / LCD_Send_Data are
+// replaced by stubs that record every panel byte and apply it to a DDRAM model, so each commit can be checked
+// byte for byte. Build:
+//   cc -O2 -DTRACKER_HOST -o lcd_test lcd_test.c lcd_buffer.c
+// Usage:
+//   lcd_test [-n frames] [-s seed]   Exits non-zero if any check fails
+//
+// Checks:
+//   cases    known frame pairs queue exactly the expected bytes: nothing for an unchanged frame, one cursor
+//            command per run of changed cells, a one-cell gap rewritten instead of jumped, a two-cell gap
+//            jumped, no command when the cursor is already in place (also across commits), a row change
+//   random   random frame pairs: the panel ends up showing the back buffer, and each commit queues exactly
+//            the bytes the coalescing rule gives
+//   counters lcd_frames, lcd_bytes_last_frame, lcd_bytes_total and lcd_queue_overflows follow the commits,
+//            and a truncated commit is completed by the next one
+
+#include "lcd_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LOG_MAX 256
+
+static uint16_t sent[LOG_MAX];    // Panel bytes since the last Log_Reset (0x100 | byte for commands)
+static int sent_count = 0;
+static unsigned char ddram[0x80]; // Panel model: DDRAM contents and the address counter
+static unsigned char address = 0;
+static int failures = 0;
+
+static void Fail(const char *check, const char *detail) {
+    if (failures++ < 10)
+        printf("FAIL %-8s %s\n", check, detail);
+}
+
+// Stubs for the driver calls lcd_buffer.c makes.
+void LCD_Clear(void) {
+    memset(ddram, ' ', sizeof(ddram));
+    address = 0;
+}
+
+void LCD_Send_Command(unsigned char cmd) {
+    if (sent_count < LOG_MAX)
+        sent[sent_count++] = (uint16_t)(0x100 | cmd);
+    if (cmd & 0x80)
+        address = cmd & 0x7F;     // Set DDRAM address.
+}
+
+void LCD_Send_Data(unsigned char data) {
+    if (sent_count < LOG_MAX)
+        sent[sent_count++] = data;
+    ddram[address++ & 0x7F] = data;
+}
+
+static void Log_Reset(void) {
+    sent_count = 0;
+}
+
+static void Flush(void) {
+    while (LCD_Flush_Step())
+        ;
+}
+
+// Commits, flushes and compares the bytes sent with 'want' (commands written as 0x100 | byte).
+static void Expect(const char *name, const uint16_t *want, int count) {
+    char detail[200];
+    Log_Reset();
+    int queued = LCD_Commit();
+    Flush();
+    int same = sent_count == count && queued == count && (int)lcd_bytes_last_frame == count;
+    for (int i = 0; same && i < count; i++)
+        same = sent[i] == want[i];
+    if (!same) {
+        int n = snprintf(detail, sizeof(detail), "%s: sent", name);
+        for (int i = 0; i < sent_count && n < 150; i++)
+            n += snprintf(detail + n, sizeof(detail) - (size_t)n, " %03X", sent[i]);
+        snprintf(detail + n, sizeof(detail) - (size_t)n, " (%d bytes, commit said %d)", sent_count, queued);
+        Fail("cases", detail);
+    }
+}
+
+#define CMD(a) (0x100 | 0x80 | (a))
+#define EXPECT(name, ...)                                                          \
+    do {                                                                           \
+        static const uint16_t want[] = { __VA_ARGS__ };                            \
+        Expect(name, want, (int)(sizeof(want) / sizeof(want[0])));                 \
+    } while (0)
+
+static void Check_Cases(void) {
+    LCD_Buffer_Init();            // Blank panel, cursor at 0x00.
+    Log_Reset();
+    uint32_t frames = lcd_frames;
+    if (LCD_Commit() != 0 || lcd_frames != frames || lcd_bytes_last_frame != 0)
+        Fail("cases", "unchanged frame queued bytes or counted a frame");
+
+    LCD_Put_At(0, 0, 'A');        // Cursor already at 0x00: no command.
+    EXPECT("cursor in place", 'A');
+    LCD_Put_At(1, 0, 'B');        // Left at 0x01 by the previous commit.
+    EXPECT("cursor kept across commits", 'B');
+    LCD_Printf_At(5, 0, "xyz");   // One run: one command.
+    EXPECT("run", CMD(0x05), 'x', 'y', 'z');
+    LCD_Put_At(10, 0, '1');       // One unchanged cell between: rewrite it instead of jumping.
+    LCD_Put_At(12, 0, '2');
+    EXPECT("one-cell gap", CMD(0x0A), '1', ' ', '2');
+    LCD_Put_At(2, 0, 'p');        // Two unchanged cells between: jump.
+    LCD_Put_At(5, 0, 'q');
+    EXPECT("two-cell gap", CMD(0x02), 'p', CMD(0x05), 'q');
+    LCD_Put_At(15, 0, 'e');       // End of row 0, then the start of row 1.
+    LCD_Put_At(0, 1, 's');
+    EXPECT("row change", CMD(0x0F), 'e', CMD(0x40), 's');
+    LCD_Put_At(1, 1, 't');        // Row 1 continues where the last commit stopped.
+    EXPECT("row 1 in place", 't');
+    LCD_Put_At(1, 1, 't');        // Same character again: nothing to send.
+    frames = lcd_frames;
+    if (LCD_Commit() != 0 || lcd_frames != frames)
+        Fail("cases", "rewriting a cell with the same character queued bytes");
+}
+
+// Bytes the coalescing rule gives for the differences between 'panel' and 'want', from cursor 'at'.
+static int Reference_Bytes(char panel[LCD_ROWS][LCD_COLS], char want[LCD_ROWS][LCD_COLS], int at) {
+    int bytes = 0;
+    for (int row = 0; row < LCD_ROWS; row++)
+        for (int col = 0; col < LCD_COLS; col++) {
+            if (panel[row][col] == want[row][col])
+                continue;
+            int addr = (row ? 0x40 : 0x00) + col;
+            bytes += addr == at ? 1 : 2;  // A one-cell gap (rewrite) and a jump (command) both cost one byte.
+            at = addr + 1;
+        }
+    return bytes;
+}
+
+static void Check_Random(int count) {
+    static char panel[LCD_ROWS][LCD_COLS], want[LCD_ROWS][LCD_COLS];
+    char detail[120];
+    int at = 0;
+    LCD_Buffer_Init();            // Also resets lcd_bytes_total.
+    lcd_frames = 0;
+    memset(panel, ' ', sizeof(panel));
+    for (int f = 0; f < count; f++) {
+        // A new frame: a few changed runs, or now and then a complete redraw.
+        memcpy(want, panel, sizeof(want));
+        int changes = rand() % 8 == 0 ? LCD_ROWS * LCD_COLS : rand() % 6;
+        for (int c = 0; c < changes; c++) {
+            int row = rand() % LCD_ROWS, col = rand() % LCD_COLS, len = 1 + rand() % 4;
+            if (changes == LCD_ROWS * LCD_COLS) {
+                row = c / LCD_COLS;
+                col = c % LCD_COLS;
+                len = 1;
+            }
+            for (int i = 0; i < len && col + i < LCD_COLS; i++)
+                want[row][col + i] = (char)('!' + rand() % 90);
+        }
+        for (int row = 0; row < LCD_ROWS; row++)
+            for (int col = 0; col < LCD_COLS; col++)
+                LCD_Put_At((unsigned char)col, (unsigned char)row, want[row][col]);
+
+        int reference = Reference_Bytes(panel, want, at);
+        uint32_t total = lcd_bytes_total;
+        Log_Reset();
+        int queued = LCD_Commit();
+        Flush();
+        if (queued != reference || sent_count != queued || lcd_bytes_total - total != (uint32_t)queued) {
+            snprintf(detail, sizeof(detail), "frame %d: queued %d, sent %d, expected %d", f, queued, sent_count,
+                     reference);
+            Fail("random", detail);
+        }
+        for (int row = 0; row < LCD_ROWS; row++)
+            if (memcmp(&ddram[row ? 0x40 : 0x00], want[row], LCD_COLS) != 0) {
+                snprintf(detail, sizeof(detail), "frame %d: row %d is '%.16s', expected '%.16s'", f, row,
+                         (const char *)&ddram[row ? 0x40 : 0x00], want[row]);
+                Fail("random", detail);
+            }
+        memcpy(panel, want, sizeof(panel));
+        if (queued)
+            at = address;
+    }
+    printf("%d random frames: %lu with changes, %.1f bytes per changed frame\n", count, (unsigned long)lcd_frames,
+           lcd_frames ? (double)lcd_bytes_total / lcd_frames : 0.0);
+}
+
+static void Check_Overflow(void) {
+    char detail[120];
+    LCD_Buffer_Init();
+    uint32_t overflows = lcd_queue_overflows;
+    // Two full redraws without a flush in between (33 bytes each: the cursor starts at 0x00, so row 0 needs no
+    // command): the second fills the queue and stops.
+    LCD_Printf_At(0, 0, "0123456789abcdef");
+    LCD_Printf_At(0, 1, "ghijklmnopqrstuv");
+    int first = LCD_Commit();
+    LCD_Printf_At(0, 0, "ABCDEFGHIJKLMNOP");
+    LCD_Printf_At(0, 1, "QRSTUVWXYZ[]^_`{");
+    int second = LCD_Commit();
+    if (first != 33 || lcd_queue_overflows != overflows + 1 || first + second != LCD_QUEUE_SIZE) {
+        snprintf(detail, sizeof(detail), "full redraws queued %d and %d, overflows %lu", first, second,
+                 (unsigned long)(lcd_queue_overflows - overflows));
+        Fail("counters", detail);
+    }
+    Flush();
+    LCD_Commit();                 // The cells that did not fit.
+    Flush();
+    if (memcmp(&ddram[0x00], "ABCDEFGHIJKLMNOP", LCD_COLS) != 0 ||
+        memcmp(&ddram[0x40], "QRSTUVWXYZ[]^_`{", LCD_COLS) != 0)
+        Fail("counters", "the commit after an overflow did not complete the frame");
+}
+
+int main(int argc, char **argv) {
+    int count = 200000, opt;
+    unsigned seed = 1;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            count = atoi(optarg);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    srand(seed);
+    Check_Cases();
+    Check_Overflow();
+    Check_Random(count);
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,125 @@
+//link_protocol.c
+
+#include "link_protocol.h"
+
+uint16_t Link_Crc16(const uint8_t *data, uint32_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void Put_U16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void Put_U32(uint8_t *p, uint32_t v) {
+    Put_U16(p, (uint16_t)v);
+    Put_U16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t Get_U16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t Get_U32(const uint8_t *p) {
+    return Get_U16(p) | ((uint32_t)Get_U16(p + 2) << 16);
+}
+
+int Link_Encode_Price(uint8_t *out, uint8_t seq, const Link_Price *price) {
+    uint8_t *payload = out + LINK_HEADER_SIZE;
+    out[0] = LINK_SYNC;
+    out[1] = (uint8_t)((LINK_VERSION << 4) | LINK_TYPE_PRICE);
+    out[2] = LINK_PRICE_PAYLOAD;
+    out[3] = seq;
+    payload[0] = price->asset_id;
+    Put_U32(payload + 1, (uint32_t)price->price_cents);
+    Put_U16(payload + 5, (uint16_t)price->change_bp);
+    Put_U32(payload + 7, price->timestamp);
+    Put_U16(payload + LINK_PRICE_PAYLOAD, Link_Crc16(out + 1, 3 + LINK_PRICE_PAYLOAD));
+    return LINK_PRICE_FRAME;
+}
+
+void Link_Decoder_Init(Link_Decoder *d) {
+    uint8_t *p = (uint8_t *)d;
+    for (uint32_t i = 0; i < sizeof(*d); i++)
+        p[i] = 0;
+}
+
+// Drops buf[0] to buf[from - 1] and everything after them up to the next sync byte; returns how many
+// bytes past 'from' were dropped.
+static uint8_t Link_Drop(Link_Decoder *d, uint8_t from) {
+    uint8_t start = from;
+    while (from < d->len && d->buf[from] != LINK_SYNC)
+        from++;
+    for (uint8_t i = from; i < d->len; i++)
+        d->buf[i - from] = d->buf[i];
+    d->len = (uint8_t)(d->len - from);
+    return (uint8_t)(from - start);
+}
+
+// Looks for a complete frame at the start of the buffer, resynchronizing past bad ones.
+static int Link_Scan(Link_Decoder *d) {
+    // Re-check after every resync: the bytes already buffered may hold the start of the real frame.
+    while (d->len > 0) {
+        if ((d->len >= 2 && (d->buf[1] >> 4) != LINK_VERSION) || (d->len >= 3 && d->buf[2] > LINK_MAX_PAYLOAD)) {
+            d->header_errors++;
+            d->skipped += 1U + Link_Drop(d, 1);
+            continue;
+        }
+        if (d->len < LINK_HEADER_SIZE || d->len < LINK_HEADER_SIZE + d->buf[2] + LINK_CRC_SIZE)
+            return LINK_PENDING;  // Frame not complete yet.
+        uint8_t body = (uint8_t)(3 + d->buf[2]);  // Bytes covered by the CRC.
+        if (Link_Crc16(d->buf + 1, body) != Get_U16(d->buf + 1 + body)) {
+            d->crc_errors++;
+            d->skipped += 1U + Link_Drop(d, 1);
+            continue;
+        }
+        // Good frame: copy it out and keep any bytes behind it (a resync inside a corrupted frame can have
+        // buffered the start of the next one) for the next scan.
+        uint8_t frame_len = (uint8_t)(LINK_HEADER_SIZE + d->buf[2] + LINK_CRC_SIZE);
+        for (uint8_t i = 0; i < frame_len; i++)
+            d->frame[i] = d->buf[i];
+        if (d->have_seq)
+            d->dropped += (uint8_t)(d->frame[3] - d->last_seq - 1);  // Gap in sequence numbers.
+        d->last_seq = d->frame[3];
+        d->have_seq = 1;
+        d->frames++;
+        d->skipped += Link_Drop(d, frame_len);
+        return LINK_FRAME;
+    }
+    return LINK_PENDING;          // The byte was swallowed by a resync.
+}
+
+int Link_Decoder_Feed(Link_Decoder *d, uint8_t byte) {
+    if (d->len == 0 && byte != LINK_SYNC)
+        return LINK_NOT_FRAMED;   // Not inside a frame: the byte belongs to someone else.
+    d->buf[d->len++] = byte;
+    return Link_Scan(d);
+}
+
+int Link_Decoder_Poll(Link_Decoder *d) {
+    return Link_Scan(d);
+}
+
+int Link_Frame_Type(const Link_Decoder *d) {
+    return d->frame[1] & 0x0F;
+}
+
+int Link_Decode_Price(const Link_Decoder *d, Link_Price *price) {
+    const uint8_t *payload = d->frame + LINK_HEADER_SIZE;
+    if (Link_Frame_Type(d) != LINK_TYPE_PRICE || d->frame[2] < LINK_PRICE_PAYLOAD)
+        return 0;
+    uint32_t cents = Get_U32(payload + 1);
+    if (cents > 0x7FFFFFFFUL)
+        return 0;                 // Out of range for the firmware's int32 cents.
+    price->asset_id = payload[0];
+    price->price_cents = (int32_t)cents;
+    price->change_bp = (int16_t)Get_U16(payload + 5);
+    price->timestamp = Get_U32(payload + 7);
+    return 1;
+}
@@ -0,0 +1,99 @@
+//link_protocol.h
+// Binary frame format for the ESP32 -> TM4C UART link. Plain C with no hardware dependencies, so the same
+// code builds into the ESP32 sketches, the TM4C firmware and host tools.
+//
+// Frame layout (multi-byte fields little-endian):
+//   [0]      LINK_SYNC (0xA5)
+//   [1]      version (high nibble) | frame type (low nibble)
+//   [2]      payload length
+//   [3]      sequence number (incremented per frame by the sender, wraps at 256)
+//   [4..]    payload
+//   [last 2] CRC-16/CCITT-FALSE over bytes [1] through the end of the payload
+//
+// LINK_TYPE_PRICE payload (11 bytes): asset id (u8), price in cents (u32), 24h change in basis points
+// (i16, 1 bp = 0.01 %), timestamp in Unix seconds (u32).
+#ifndef LINK_PROTOCOL_H           // Prevent multiple inclusions
+#define LINK_PROTOCOL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {                      // The ESP32 sketches are C++
+#endif
+
+#define LINK_SYNC          0xA5   // First byte of every frame (never appears in the ASCII text lines)
+#define LINK_VERSION       1      // Bumped whenever the layout of an existing frame type changes
+#define LINK_TYPE_PRICE    1      // Price update for one asset
+#define LINK_HEADER_SIZE   4      // Sync, version/type, length, sequence
+#define LINK_CRC_SIZE      2
+#define LINK_MAX_PAYLOAD   32     // Longest payload the decoder accepts
+#define LINK_MAX_FRAME     (LINK_HEADER_SIZE + LINK_MAX_PAYLOAD + LINK_CRC_SIZE)
+#define LINK_PRICE_PAYLOAD 11
+#define LINK_PRICE_FRAME   (LINK_HEADER_SIZE + LINK_PRICE_PAYLOAD + LINK_CRC_SIZE)  // 17 bytes on the wire
+
+// Tracked assets as X(ticker, CoinGecko id). An asset's position in this list is its id in price frames,
+// so both sides must be built from the same list; append new assets at the end.
+#define LINK_ASSET_LIST(X) \
+    X(BTC,  "bitcoin")     \
+    X(ETH,  "ethereum")    \
+    X(SOL,  "solana")      \
+    X(XRP,  "ripple")      \
+    X(ADA,  "cardano")     \
+    X(DOGE, "dogecoin")    \
+    X(LTC,  "litecoin")    \
+    X(DOT,  "polkadot")    \
+    X(LINK, "chainlink")   \
+    X(TRX,  "tron")
+
+#define LINK_ASSET_ENUM(ticker, id) LINK_ASSET_##ticker,
+enum {
+    LINK_ASSET_LIST(LINK_ASSET_ENUM)
+    LINK_ASSET_COUNT              // Number of assets in the list
+};
+#undef LINK_ASSET_ENUM
+
+// Decoded LINK_TYPE_PRICE payload.
+typedef struct {
+    uint8_t asset_id;             // Which asset this price belongs to
+    int32_t price_cents;          // Price in US cents
+    int16_t change_bp;            // 24h change in basis points
+    uint32_t timestamp;           // Unix seconds when the sender took the price (0 if unknown)
+} Link_Price;
+
+// Streaming decoder state. Feed it every received byte; it locks onto LINK_SYNC, validates length,
+// version and CRC, and after a bad frame resynchronizes on the next sync byte already buffered. Bytes
+// buffered behind a good frame (left over from a resync) stay queued and are checked again.
+typedef struct {
+    uint8_t buf[LINK_MAX_FRAME];  // Frame being assembled (buf[0] is always LINK_SYNC while len > 0)
+    uint8_t len;                  // Bytes in buf
+    uint8_t frame[LINK_MAX_FRAME];  // Last good frame (read with Link_Frame_Type / Link_Decode_Price)
+    uint8_t last_seq;             // Sequence number of the last good frame
+    uint8_t have_seq;             // 1 once a good frame has been seen
+    uint32_t frames;              // Good frames decoded
+    uint32_t crc_errors;          // Frames rejected by the CRC
+    uint32_t header_errors;       // Frames rejected for an unknown version or oversized length
+    uint32_t dropped;             // Frames missing according to the sequence numbers
+    uint32_t skipped;             // Bytes discarded while resynchronizing
+} Link_Decoder;
+
+// Link_Decoder_Feed results:
+#define LINK_NOT_FRAMED 0         // Byte is not part of a frame (e.g. ASCII text); pass it on
+#define LINK_PENDING    1         // Byte was consumed by a frame in progress
+#define LINK_FRAME      2         // A valid frame is complete: read it with Link_Frame_Type / Link_Decode_Price
+
+uint16_t Link_Crc16(const uint8_t *data, uint32_t len);  // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+int Link_Encode_Price(uint8_t *out, uint8_t seq, const Link_Price *price);  // Writes LINK_PRICE_FRAME bytes
+
+void Link_Decoder_Init(Link_Decoder *d);
+int Link_Decoder_Feed(Link_Decoder *d, uint8_t byte);
+int Link_Decoder_Poll(Link_Decoder *d);
+// After LINK_FRAME: check the bytes still buffered for another complete frame without feeding a new one.
+// Returns LINK_FRAME (handle it and poll again) or LINK_PENDING.
+int Link_Frame_Type(const Link_Decoder *d);   // Type of the last good frame
+int Link_Decode_Price(const Link_Decoder *d, Link_Price *price);  // Returns 1 if the frame held a valid price
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LINK_PROTOCOL_H
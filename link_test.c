@@ -0,0 +1,288 @@
+//link_test.c
+// Host test for the UART link codec: price frames from Link_Encode_Price (the encoder the ESP32 sketches
+// use), mixed with the ASCII status lines the sketches still print, go through a wire model that flips
+// bits, loses bytes and adds line noise, and then through Link_Decoder_Feed / Link_Decoder_Poll like in
+// main.c. Build:
+//   cc -O2 -o link_test link_test.c link_protocol.c
+// Usage:
+//   link_test [-n frames] [-s seed]   Exits non-zero if any check fails
+//
+// Checks:
+//   clean   without errors every frame decodes, no byte is skipped and the text between frames comes
+//           through unchanged
+//   errors  every frame the decoder accepts was sent, in order; every frame that crossed the wire intact
+//           is accepted (also when it was buffered behind a corrupted one); 'dropped' matches the frames
+//           lost between accepted ones
+//   resync  a frame whose length byte was corrupted costs only itself, not the frames buffered behind it
+
+#include "link_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEXT_EVERY  8             // About one status line per 8 frames
+#define GAP_LIMIT   256           // 'dropped' comes from 8-bit sequence numbers: gaps must stay below this
+
+typedef struct {
+    const char *name;
+    double bit_error;             // Probability that a bit on the wire is flipped
+    double lost;                  // Probability that a byte is lost
+    double noise;                 // Probability of a random byte being inserted before a byte
+} Wire;
+
+static const Wire wires[] = {
+    { "clean",           0,    0,    0    },
+    { "ber 1e-5",        1e-5, 0,    0    },
+    { "ber 1e-4",        1e-4, 0,    0    },
+    { "ber 1e-3",        1e-3, 0,    0    },
+    { "ber 1e-3 + loss", 1e-3, 1e-4, 1e-4 },
+    { "ber 1e-2 + loss", 1e-2, 1e-3, 1e-3 },
+};
+
+static const char *const status_lines[] = {
+    "HTTP error: 429\n", "WiFi reconnecting...\n", "Fetching prices\r\n", "JSON parse error\n",
+};
+
+static int failures = 0;
+
+static void Fail(const char *check, const char *detail) {
+    if (failures++ < 10)
+        printf("FAIL %-8s %s\n", check, detail);
+}
+
+static double Random_Unit(void) {
+    return (double)rand() / ((double)RAND_MAX + 1);
+}
+
+static int Chance(double p) {
+    return p > 0 && Random_Unit() < p;
+}
+
+static void Random_Price(Link_Price *p) {
+    p->asset_id = (uint8_t)(rand() % LINK_ASSET_COUNT);
+    p->price_cents = (int32_t)(((uint32_t)rand() << 8 ^ (uint32_t)rand()) & 0x7FFFFFFF);
+    p->change_bp = (int16_t)(rand() % 65536 - 32768);
+    p->timestamp = 1700000000U + (uint32_t)rand();
+}
+
+static int Same_Price(const Link_Price *a, const Link_Price *b) {
+    return a->asset_id == b->asset_id && a->price_cents == b->price_cents && a->change_bp == b->change_bp &&
+           a->timestamp == b->timestamp;
+}
+
+// Appends 'count' bytes to the wire through the error model; returns 1 if any of them was damaged. Noise
+// in front of the first byte does not damage the chunk itself.
+static int Send(uint8_t *wire, uint32_t *len, const uint8_t *bytes, int count, const Wire *w) {
+    int damaged = 0;
+    for (int i = 0; i < count; i++) {
+        if (Chance(w->noise)) {
+            wire[(*len)++] = (uint8_t)rand();
+            damaged |= i > 0;
+        }
+        if (Chance(w->lost)) {
+            damaged = 1;
+            continue;
+        }
+        uint8_t b = bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+            if (Chance(w->bit_error))
+                b ^= (uint8_t)(1 << bit);
+        damaged |= b != bytes[i];
+        wire[(*len)++] = b;
+    }
+    return damaged;
+}
+
+// Streams 'count' frames with status lines in between through wire model 'w' and the decoder.
+static void Check_Wire(const Wire *w, uint32_t count) {
+    Link_Price *sent = malloc(count * sizeof(*sent));
+    uint8_t *intact = malloc(count);
+    uint8_t *wire = malloc((size_t)count * 64);
+    char *text = malloc((size_t)count * 4 + 64), *text_out = malloc((size_t)count * 64);
+    uint32_t wire_len = 0, text_len = 0, text_out_len = 0, intact_count = 0;
+    char detail[160];
+    if (!sent || !intact || !wire || !text || !text_out) {
+        Fail(w->name, "out of memory");
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t frame[LINK_PRICE_FRAME];
+        if (rand() % TEXT_EVERY == 0) {
+            const char *line = status_lines[rand() % (int)(sizeof(status_lines) / sizeof(status_lines[0]))];
+            int n = (int)strlen(line);
+            Send(wire, &wire_len, (const uint8_t *)line, n, w);
+            memcpy(text + text_len, line, (size_t)n);
+            text_len += (uint32_t)n;
+        }
+        Random_Price(&sent[i]);
+        Link_Encode_Price(frame, (uint8_t)i, &sent[i]);
+        intact[i] = !Send(wire, &wire_len, frame, LINK_PRICE_FRAME, w);
+        intact_count += intact[i];
+    }
+
+    // Decode, matching every accepted frame against the next frames sent.
+    Link_Decoder d;
+    Link_Decoder_Init(&d);
+    uint32_t next = 0, accepted = 0, false_accepts = 0, missed_intact = 0, gaps = 0, big_gaps = 0;
+    int have_previous = 0;
+    for (uint32_t at = 0; at < wire_len; at++) {
+        int result = Link_Decoder_Feed(&d, wire[at]);
+        if (result == LINK_NOT_FRAMED)
+            text_out[text_out_len++] = (char)wire[at];
+        while (result == LINK_FRAME) {
+            Link_Price p;
+            uint32_t k = next, end = next + 4 * GAP_LIMIT < count ? next + 4 * GAP_LIMIT : count;
+            if (Link_Decode_Price(&d, &p))
+                while (k < end && !(Same_Price(&sent[k], &p) && (uint8_t)k == d.last_seq))
+                    k++;
+            if (k >= end) {
+                false_accepts++;
+            } else {
+                for (uint32_t j = next; j < k; j++)
+                    missed_intact += intact[j];
+                if (have_previous) {
+                    gaps += k - next;
+                    big_gaps += k - next >= GAP_LIMIT;
+                }
+                if (!intact[k] && k + 1 < count)
+                    intact[k + 1] = 0;  // Damaged but still decoded (a lost CRC byte of 0xA5): it took the next sync.
+                have_previous = 1;
+                next = k + 1;
+                accepted++;
+            }
+            result = Link_Decoder_Poll(&d);
+        }
+    }
+    for (uint32_t j = next; j < count; j++)
+        missed_intact += intact[j] && j + 1 < count;  // The last frame may still sit in the buffer.
+
+    printf("%-16s %8lu %8lu %8lu %8lu %8lu %8lu %10lu\n", w->name, (unsigned long)count,
+           (unsigned long)accepted, (unsigned long)d.dropped, (unsigned long)d.crc_errors,
+           (unsigned long)d.header_errors, (unsigned long)d.skipped, (unsigned long)false_accepts);
+    // A 16-bit CRC passes one random bad frame in 65536: allow that rate (four times over), but then the
+    // sequence and intact-frame checks no longer hold for this wire.
+    if (false_accepts > 1 + (d.crc_errors + d.header_errors) / 16384) {
+        snprintf(detail, sizeof(detail), "%s: %lu accepted frame(s) were never sent", w->name,
+                 (unsigned long)false_accepts);
+        Fail("errors", detail);
+    }
+    if (!false_accepts && missed_intact) {
+        snprintf(detail, sizeof(detail), "%s: %lu of %lu intact frames were not decoded", w->name,
+                 (unsigned long)missed_intact, (unsigned long)intact_count);
+        Fail("errors", detail);
+    }
+    if (!false_accepts && !big_gaps && d.dropped != gaps) {
+        snprintf(detail, sizeof(detail), "%s: dropped counter %lu, frames actually lost %lu", w->name,
+                 (unsigned long)d.dropped, (unsigned long)gaps);
+        Fail("errors", detail);
+    }
+    if (w->bit_error == 0 && w->lost == 0 && w->noise == 0 &&
+        (accepted != count || d.skipped || d.crc_errors || d.header_errors || text_out_len != text_len ||
+         memcmp(text, text_out, text_len) != 0)) {
+        snprintf(detail, sizeof(detail), "%lu of %lu frames, %lu bytes skipped, text %s", (unsigned long)accepted,
+                 (unsigned long)count, (unsigned long)d.skipped,
+                 text_out_len == text_len && memcmp(text, text_out, text_len) == 0 ? "intact" : "damaged");
+        Fail("clean", detail);
+    }
+    free(sent);
+    free(intact);
+    free(wire);
+    free(text);
+    free(text_out);
+}
+
+// Writes a frame of any type, as a sender of a future protocol version would.
+static int Put_Frame(uint8_t *out, int type, uint8_t seq, const uint8_t *payload, uint8_t len) {
+    out[0] = LINK_SYNC;
+    out[1] = (uint8_t)((LINK_VERSION << 4) | type);
+    out[2] = len;
+    out[3] = seq;
+    memcpy(out + LINK_HEADER_SIZE, payload, len);
+    uint16_t crc = Link_Crc16(out + 1, 3U + len);
+    out[LINK_HEADER_SIZE + len] = (uint8_t)crc;
+    out[LINK_HEADER_SIZE + len + 1] = (uint8_t)(crc >> 8);
+    return LINK_HEADER_SIZE + len + LINK_CRC_SIZE;
+}
+
+// Feeds 'len' bytes and checks which frames come out (by sequence number) and the decoder counters.
+static void Expect(const char *name, const uint8_t *bytes, int len, const uint8_t *seqs, uint32_t frames,
+                   uint32_t dropped, uint32_t crc_errors, uint32_t skipped) {
+    Link_Decoder d;
+    uint32_t got = 0;
+    int ok = 1;
+    char detail[160];
+    Link_Decoder_Init(&d);
+    for (int i = 0; i < len; i++) {
+        int result = Link_Decoder_Feed(&d, bytes[i]);
+        while (result == LINK_FRAME) {
+            ok &= got < frames && d.last_seq == seqs[got];
+            got++;
+            result = Link_Decoder_Poll(&d);
+        }
+    }
+    printf("%-32s frames %lu, dropped %lu, crc errors %lu, skipped %lu\n", name, (unsigned long)d.frames,
+           (unsigned long)d.dropped, (unsigned long)d.crc_errors, (unsigned long)d.skipped);
+    if (!ok || got != frames || d.frames != frames || d.dropped != dropped || d.crc_errors != crc_errors ||
+        d.skipped != skipped) {
+        snprintf(detail, sizeof(detail), "%s: expected frames %lu, dropped %lu, crc errors %lu, skipped %lu",
+                 name, (unsigned long)frames, (unsigned long)dropped, (unsigned long)crc_errors,
+                 (unsigned long)skipped);
+        Fail("resync", detail);
+    }
+}
+
+// A corrupted length byte makes the decoder buffer the frames behind the bad one before the CRC fails.
+static void Check_Resync(void) {
+    static const uint8_t seqs[] = { 0, 2, 3, 4, 5 };
+    uint8_t bytes[128];
+    uint8_t empty[1];
+    Link_Price p = { LINK_ASSET_BTC, 6000000, 250, 1700000000 };  // No 0xA5 inside these frames.
+    int n = 0;
+
+    // Length of price frame A raised to 32: it swallows B and the first 4 bytes of C.
+    n += Link_Encode_Price(bytes + n, 0, &p);
+    int a = n;
+    n += Link_Encode_Price(bytes + n, 1, &p);
+    bytes[a + 2] = LINK_MAX_PAYLOAD;
+    n += Link_Encode_Price(bytes + n, 2, &p);
+    n += Link_Encode_Price(bytes + n, 3, &p);
+    Expect("price A (length 32), B, C", bytes, n, seqs, 3, 1, 1, LINK_PRICE_FRAME);
+
+    // Same with empty frames of another type behind it: three of them are already buffered when the CRC
+    // of A fails, so they come out of Link_Decoder_Poll.
+    n = 0;
+    n += Link_Encode_Price(bytes + n, 0, &p);
+    a = n;
+    n += Link_Encode_Price(bytes + n, 1, &p);
+    bytes[a + 2] = LINK_MAX_PAYLOAD;
+    n += Put_Frame(bytes + n, 2, 2, empty, 0);
+    n += Put_Frame(bytes + n, 2, 3, empty, 0);
+    n += Put_Frame(bytes + n, 2, 4, empty, 0);
+    n += Put_Frame(bytes + n, 2, 5, empty, 0);
+    Expect("price A (length 32), 4 empty", bytes, n, seqs, 5, 1, 1, LINK_PRICE_FRAME);
+}
+
+int main(int argc, char **argv) {
+    uint32_t count = 100000;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            count = (uint32_t)strtoul(optarg, 0, 10);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    srand(seed);
+    printf("%-16s %8s %8s %8s %8s %8s %8s %10s\n", "wire", "sent", "decoded", "dropped", "crc err", "hdr err",
+           "skipped", "false acc");
+    for (unsigned i = 0; i < sizeof(wires) / sizeof(wires[0]); i++)
+        Check_Wire(&wires[i], count);
+    printf("\n");
+    Check_Resync();
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
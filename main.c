@@ -1,126 +1,414 @@
-
 //  @file main.c
 
-#include "tracker.h"          
-#include <stdio.h>               
-
-int main(void) {                 
-    char uart_buffer[BUFFER_SIZE];  // Declare a buffer to store received UART characters.
-    uint8_t index = 0;         // Initialize an index to track the current position in uart_buffer.
-    float price = 0.0f, change = 0.0f;  // Variables to store the parsed BTC price and 24h change percentage.
-    char line2[17] = {0};      // A string buffer for formatting the second line of LCD output (16 characters + null terminator).
-    
-    // Declare an array of threshold values for price alert (from 10,000 to 120,000).
-    int thresholds[] = {10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000, 90000, 100000, 110000, 120000};
-    int total_thresholds = sizeof(thresholds) / sizeof(thresholds[0]);  
-    // Calculate the number of thresholds by dividing the total size of the array by the size of one element.
-    int adjustable_index = 0;  // Index into the thresholds array; initially set to 0.
-    char threshStr[17] = {0};  // Buffer for formatting threshold string for LCD display (16 characters max + null terminator).
-    uint32_t elapsed = 0;      // Timer variable to count elapsed time in the threshold adjustment phase.
+#include "tracker.h"
+#include "scheduler.h"
+#include "lcd_buffer.h"
+#include "price_format.h"
+#include "link_protocol.h"
+#include "asset_table.h"
+#include "alert.h"
+#include "history.h"
+#include "profile.h"
+#include "config_store.h"
+#include <string.h>
+
+// Application phases: pick a threshold, confirm it, then track prices.
+#define PHASE_PICK  0             // "Set min val:" screen, button cycles through thresholds
+#define PHASE_SAVED 1             // "Threshold Saved" confirmation screen
+#define PHASE_RUN   2             // Normal price display and alerting
+
+#define PICK_TIMEOUT_MS   4000    // Threshold picker closes 4 s after the last button press
+#define SAVED_SCREEN_MS   3000    // "Threshold Saved" stays up for 3 s
+#define BUTTON_SAMPLE_MS  10      // Button is sampled every 10 ms
+#define BUTTON_DEBOUNCE   3       // Number of identical samples (30 ms) before a level change is accepted
+#define BUTTON_REPEAT_MS  400     // Holding the button in the picker advances once every 400 ms
+#define ALERT_CADENCE_MS  150     // One step of the 8-step alert output patterns (see alert.h)
+#define ALERT_SNOOZE_MS   300000  // A press on the alert screen silences the alert for 5 minutes...
+#define ALERT_ACK_HOLD_MS 1500    // ...holding it for 1.5 s acknowledges it until the condition clears
+#define DISPLAY_PERIOD_MS 50      // How often the display job checks for a pending redraw
+#define PAGE_PERIOD_MS    3000    // Each tracked asset is shown for 3 s before the view rotates
+#define STORE_PERIOD_MS   1       // EEPROM writes go out one word per millisecond (a word takes ~110 us)
+#define CACHE_CHECK_MS    1000    // How often the price cache is checked for changes...
+#define CACHE_SAVE_MS     300000  // ...and saved at most every 5 minutes (spread over 8 slots: decades of wear)
+
+// Default BTC rules next to the picked threshold: a 5 % drop within an hour and a fall faster than
+// 1 % per minute over 5 minutes. Both re-arm once the move has eased off by 1 %.
+#define MOVE_LEVEL_BP   -500
+#define MOVE_WINDOW_MS  3600000
+#define RATE_LEVEL_BP   -100
+#define RATE_WINDOW_MS  300000
+#define MOVE_HYST_BP    100
+#define THRESHOLD_HYST_CENTS 5000 // The threshold alert re-arms once the price is $50 back above it
+
+// Declare an array of threshold values for price alert (from 10,000 to 120,000).
+static const int thresholds[] = {10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000, 90000, 100000, 110000, 120000};
+static const int total_thresholds = sizeof(thresholds) / sizeof(thresholds[0]);
+// Calculate the number of thresholds by dividing the total size of the array by the size of one element.
+
+static int phase = PHASE_PICK;    // Current application phase.
+static int adjustable_index = 0;  // Index into the thresholds array; initially set to 0.
+static int display_dirty = 1;     // Set whenever the screen content must be redrawn.
+static int loading = 0;           // 1 after an unparsable line, until the next valid price.
+static int framed = 0;            // 1 once a binary frame has arrived: text lines are then status messages.
+static int page = -1;             // Asset shown on the LCD (-1 until the first price arrives).
+static int phase_job = -1;        // Scheduler id of the picker/confirmation timeout job.
+static int page_job = -1;         // Scheduler id of the page rotation job.
+static int threshold_rule = -1;   // Alert rule for the picked BTC threshold.
+static int held_rule = -1;        // Rule snoozed by the current button press (upgraded to ACKED if held).
+static int boot_hold = 0;         // 1 while the button held at power-up (to open the picker) is still down.
+static int cache_dirty = 0;       // 1 when a live price arrived since the cache was last saved.
+static int job_table_full = 0;    // 1 if a job did not fit in the scheduler (SCHEDULER_MAX_JOBS too small).
+
+// Returns the sounding alert rule (see Alert_Active), or -1. Alerts stay quiet outside the price display.
+static int Alert_Rule_Active(void) {
+    if (phase != PHASE_RUN || loading)
+        return -1;
+    return Alert_Active(SysTick_Millis());
+}
+
+// Shows the normal up/down colour for the asset on screen (or turns the LED off if there is none).
+static void LED_Show_Page(void) {
+    if (page >= 0)
+        RGB_LED_Set_Normal(asset_change[page]);
+    else
+        GPIOD->DATA &= ~0x03;     // Turn off the RGB LED.
+}
+
+// Handles a debounced button press according to the current phase.
+static void Button_Pressed_Event(void) {
+    if (phase == PHASE_PICK) {
+        // Cycle to the next threshold; modulo wraps the index at the end of the thresholds array.
+        adjustable_index = (adjustable_index + 1) % total_thresholds;
+        display_dirty = 1;
+        Scheduler_Restart(phase_job, PICK_TIMEOUT_MS);  // Give the user another 4 s after each press.
+    } else if (phase == PHASE_RUN && Alert_Rule_Active() >= 0) {
+        held_rule = Alert_Rule_Active();
+        Alert_Snooze(held_rule, ALERT_SNOOZE_MS, SysTick_Millis());  // Silence it; held long enough, it is acked.
+        if (Alert_Rule_Active() < 0) {
+            Buzzer_Off();         // That was the last sounding alert.
+            LED_Show_Page();
+        }
+        display_dirty = 1;
+    } else if (phase == PHASE_RUN && page >= 0) {
+        page = Asset_Next_Valid(page);  // No alert: the button flips to the next asset.
+        Scheduler_Restart(page_job, PAGE_PERIOD_MS);
+        LED_Show_Page();
+        display_dirty = 1;
+    }
+}
+
+// Job: sample and debounce the push button, with auto-repeat while it is held in the picker.
+static void Button_Job(void) {
+    static int stable = 0;        // Debounced button state (1 = pressed).
+    static int count = 0;         // Consecutive samples that disagree with 'stable'.
+    static uint32_t held_ms = 0;  // How long the button has been held down.
+    int raw = PushButton_Pressed();
+    if (raw != stable) {
+        if (++count >= BUTTON_DEBOUNCE) {
+            stable = raw;         // Level has been steady long enough: accept it.
+            count = 0;
+            held_ms = 0;
+            held_rule = -1;
+            if (stable && !boot_hold)
+                Button_Pressed_Event();
+            if (!stable)
+                boot_hold = 0;    // The power-up hold is over: presses count from now on.
+        }
+    } else {
+        count = 0;
+        if (stable && phase == PHASE_PICK && !boot_hold) {
+            held_ms += BUTTON_SAMPLE_MS;
+            if (held_ms >= BUTTON_REPEAT_MS) {
+                held_ms = 0;
+                Button_Pressed_Event();  // Auto-repeat, like holding the button in the original picker loop.
+            }
+        } else if (stable && held_rule >= 0) {
+            held_ms += BUTTON_SAMPLE_MS;
+            if (held_ms >= ALERT_ACK_HOLD_MS) {
+                Alert_Acknowledge(held_rule);  // Long press: silent until the condition clears.
+                held_rule = -1;
+            }
+        }
+    }
+}
+
+// Job (one-shot): closes the picker, then the confirmation screen.
+static void Phase_Timeout_Job(void) {
+    if (phase == PHASE_PICK) {
+        // Save the selected threshold as the level of the BTC threshold rule.
+        Alert_Set_Level(threshold_rule, (int32_t)thresholds[adjustable_index] * 100, THRESHOLD_HYST_CENTS);
+        Store_Save_Config(adjustable_index, threshold_rule);  // Next power-up goes straight to the prices.
+        phase = PHASE_SAVED;
+        Scheduler_Restart(phase_job, SAVED_SCREEN_MS);  // Show "Threshold Saved" for 3 seconds.
+    } else {
+        phase = PHASE_RUN;        // Start showing prices, including those that arrived during the picker.
+        LED_Show_Page();
+    }
+    display_dirty = 1;
+}
+
+// Job: play the sounding rule's priority pattern on the buzzer and LED, one step per call.
+static void Alert_Output_Job(void) {
+    static uint8_t step = 0;      // Position in the 8-step pattern.
+    static int sounding = -1;     // Rule whose pattern is playing, or -1.
+    int rule = Alert_Rule_Active();
+    if (rule != sounding) {
+        step = 0;                 // Start a new alert at the beginning of its pattern.
+        display_dirty = 1;        // The alert screen appears, changes or goes away.
+        if (rule < 0) {
+            Buzzer_Off();         // Alert ended (cleared, snoozed or acknowledged).
+            LED_Show_Page();
+        }
+        sounding = rule;
+    }
+    if (rule < 0)
+        return;
+    int priority = alert_rules[rule].priority & 3;
+    Buzzer_Set(alert_buzzer_pattern[priority] >> step & 1);
+    RGB_LED_Set_Yellow(alert_led_pattern[priority] >> step & 1);
+    step = (uint8_t)((step + 1) & 7);
+}
+
+// Job: save the latest prices to the EEPROM cache once they have changed, at most every CACHE_SAVE_MS
+// (the first live price is saved straight away).
+static void Cache_Save_Job(void) {
+    static uint32_t last_save_ms = 0;
+    static int saved = 0;         // 1 after the first save.
+    if (!cache_dirty || (saved && SysTick_Millis() - last_save_ms < CACHE_SAVE_MS))
+        return;
+    Store_Save_Cache();
+    cache_dirty = 0;
+    saved = 1;
+    last_save_ms = SysTick_Millis();
+}
 
+// Job: rotate the display to the next asset that has a price.
+static void Page_Job(void) {
+    if (page < 0 || Alert_Rule_Active() >= 0)
+        return;                   // Nothing to rotate, or the alert screen is up.
+    int next = Asset_Next_Valid(page);
+    if (next != page) {
+        page = next;
+        LED_Show_Page();
+        display_dirty = 1;
+    }
+}
+
+// Job: redraw the shadow framebuffer when something changed; only the cells that differ reach the panel.
+static void Display_Job(void) {
+    if (!display_dirty)
+        return;
+    PROFILE_BEGIN(DISPLAY);
+    PROFILE_BEGIN(FORMAT);
+    char text[LCD_COLS + 1];      // Formatted price for one row.
+    int rule = Alert_Rule_Active();
+    display_dirty = 0;
+    LCD_Buffer_Clear();
+    if (phase == PHASE_PICK) {
+        LCD_Printf_At(0, 0, "Set min val:");  // Display the prompt to set the minimum value.
+        LCD_Printf_At(0, 1, "$%-7d", thresholds[adjustable_index]);  // Left-justified in a field of 7 characters.
+    } else if (phase == PHASE_SAVED) {
+        LCD_Printf_At(0, 0, "Threshold Saved");  // Inform the user that threshold is saved.
+    } else if (loading) {
+        LCD_Printf_At(0, 0, "Loading...");   // Last line did not match the expected format.
+    } else if (rule >= 0) {
+        const Alert_Rule *r = &alert_rules[rule];
+        Price_Format_Dollars(text, sizeof(text), asset_price[r->asset]);
+        LCD_Printf_At(0, 0, "%s %s", asset_ticker[r->asset], text);  // Display the asset and its price.
+        if (r->type == ALERT_BELOW) {
+            LCD_Printf_At(0, 1, "BUY NOW");  // Display the alert message.
+        } else if (r->type == ALERT_ABOVE) {
+            LCD_Printf_At(0, 1, "SELL NOW");
+        } else {
+            Price_Format_Change(text, sizeof(text), r->value, 2);
+            LCD_Printf_At(0, 1, r->type == ALERT_MOVE ? "Move %s" : "Rate %s/min", text);
+        }
+    } else if (page >= 0) {
+        char spark[HISTORY_SPARK_COLS];
+        LCD_Printf_At(0, 0, "%s", asset_ticker[page]);  // Asset label, up to 4 letters ("DOGE").
+        // Trend: the last 8 minute closes once there are a few, the last 8 ticks until then.
+        if (asset_flags[page] & ASSET_STALE) {
+            LCD_Printf_At(5, 0, "(stale)");  // Cached from before power-up until the first live price.
+        } else {
+            History_Sparkline(page, History_Count(page, HISTORY_MINUTE) >= 3 ? HISTORY_MINUTE : HISTORY_TICKS,
+                              spark);
+            for (int col = 0; col < HISTORY_SPARK_COLS; col++)
+                LCD_Put_At((unsigned char)(5 + col), 0, spark[col]);
+        }
+        if (Asset_Count_Valid() > 1) {
+            int n = snprintf(text, sizeof(text), "%d/%d", Asset_Valid_Position(page), Asset_Count_Valid());
+            if (n > 3)
+                n = snprintf(text, sizeof(text), "%d", Asset_Valid_Position(page));  // "3/10" does not fit.
+            LCD_Printf_At((unsigned char)(LCD_COLS - n), 0, "%s", text);  // Page number, right-aligned.
+        }
+        Price_Format_Line(text, sizeof(text), asset_price[page], asset_change[page]);
+        LCD_Printf_At(0, 1, "%s", text);     // Display the formatted price and change string.
+    }
+    PROFILE_END(FORMAT);
+    PROFILE_CALL(COMMIT, LCD_Commit());  // Queue the changed cells; the main loop flushes them in the background.
+    PROFILE_END(DISPLAY);
+}
+
+// Stores a new price (cents), 24h change (basis points) and sender timestamp (Unix seconds, 0 if unknown)
+// for an asset and updates the display and alerts.
+static void Process_Price(int id, int32_t new_price, int32_t new_change, uint32_t timestamp) {
+    PROFILE_BEGIN(PRICE);
+    int was_alerting = Alert_Rule_Active() >= 0;
+    loading = 0;
+    cache_dirty = 1;
+    if (new_change > 32767 || new_change < -32768)
+        new_change = new_change > 0 ? 32767 : -32768;  // Clamp to the int16 the table keeps, as the sketches do.
+    Asset_Update(id, new_price, (int16_t)new_change, timestamp);
+    PROFILE_CALL(HISTORY, History_Add(id, new_price, SysTick_Millis()));
+    PROFILE_CALL(ALERTS, Alert_Evaluate(id, new_price, SysTick_Millis()));  // Only this asset's rules.
+    if (page < 0 || !(asset_flags[page] & ASSET_VALID))
+        page = Asset_Next_Valid(ASSET_MAX - 1);  // First price: start on the lowest asset id.
+    if (phase == PHASE_RUN && Alert_Rule_Active() < 0) {
+        if (was_alerting)
+            Buzzer_Off();         // Alert just ended: make sure the buzzer is silent.
+        LED_Show_Page();          // Set the LED color according to the price change.
+    }
+    display_dirty = 1;            // During the picker only the prices are kept; they show once it closes.
+    PROFILE_END(PRICE);
+}
+
+// Parses one received text line; anything that is not a price line shows "Loading..." (text-only senders).
+static void Process_Line(const char *uart_buffer) {
+    int32_t new_price, new_change;
+    int parsed;
+#ifdef TRACKER_PROFILE
+    if (strcmp(uart_buffer, "PROFILE") == 0) {
+        Profile_Dump_Start();     // Diagnostic request: send the probe statistics over UART0.
+        return;
+    }
+#endif
+    // Parse the UART buffer expecting a format: "BTC Price: $<price>, 24h Change: <change>%"
+    PROFILE_CALL(PARSE, parsed = Price_Parse_Line(uart_buffer, &new_price, &new_change));
+    if (parsed) {
+        Process_Price(LINK_ASSET_BTC, new_price, new_change, 0);  // Text lines only ever carry BTC.
+        return;
+    }
+    if (framed)
+        return;                   // Status line ("HTTP error: 429") next to frames: prices and alerts stand.
+    if (Alert_Rule_Active() >= 0)
+        Buzzer_Off();             // The alert ends with the price: make sure the buzzer is silent.
+    loading = 1;                  // Unparsable line: show "Loading..." until a valid one arrives.
+    GPIOD->DATA &= ~0x03;         // Turn off the RGB LED.
+    display_dirty = 1;
+}
+
+// Routes one received byte: binary link frames go to the frame decoder, everything else is
+// assembled into text lines (status messages, or price lines from an older ESP32 sketch).
+static void Process_Byte(char c) {
+    static Link_Decoder decoder;  // Zero-initialized, which is the decoder's idle state.
+    static char uart_buffer[BUFFER_SIZE];  // Text line being assembled.
+    static uint8_t index = 0;     // Current position in uart_buffer.
+    Link_Price frame;
+    int result = Link_Decoder_Feed(&decoder, (uint8_t)c);
+    if (result == LINK_FRAME) {
+        framed = 1;
+        do {
+            if (Link_Decode_Price(&decoder, &frame) && frame.asset_id < ASSET_MAX)
+                Process_Price(frame.asset_id, frame.price_cents, frame.change_bp, frame.timestamp);
+        } while (Link_Decoder_Poll(&decoder) == LINK_FRAME);  // More frames already buffered behind it.
+        return;
+    }
+    if (result == LINK_PENDING || c == '\r')
+        return;                   // Inside a frame, or the first half of a "\r\n" line ending.
+    if (c == '\n' || index >= BUFFER_SIZE - 1) {
+        uart_buffer[index] = '\0';  // Null-terminate the UART buffer to form a valid string.
+        Process_Line(uart_buffer);
+        index = 0;                // Reset the buffer index after processing a complete line.
+        if (c == '\n')
+            return;
+    }
+    uart_buffer[index++] = c;     // Append the received character to the buffer.
+}
+
+// Registers a job and notes a full table, so a build with more jobs than slots stops at start-up instead of
+// running without one of them.
+static int Add_Job(Job_Function fn, uint32_t period_ms, uint32_t delay_ms) {
+    int id = Scheduler_Add(fn, period_ms, delay_ms);
+    if (id < 0)
+        job_table_full = 1;
+    return id;
+}
+
+void Tracker_Setup(void) {
     // Initialize all peripherals:
+    SysTick_Init();            // Start the 1 ms tick first: every delay and job depends on it.
     PushButton_Init();         // Initialize push button (GPIO configuration for PF4).
     RGB_LED_Init();            // Initialize the RGB LED (GPIO configuration for PD0 and PD1).
     Buzzer_Init();             // Initialize the buzzer (GPIO configuration for PF1).
     LCD_Init();                // Initialize the LCD (including port setup and command sequence).
+    LCD_Load_Glyphs(history_glyphs, 8);  // Sparkline bars in CGRAM.
+    LCD_Buffer_Init();         // Blank the panel and reset the shadow framebuffer.
     UART1_Init();              // Initialize UART1 (for receiving BTC price data).
+    Idle_Init();               // Gate the clocks that are not needed while sleeping between events.
+    Store_Init();              // Enable the EEPROM (settings and the warm-start price cache).
+#ifdef TRACKER_PROFILE
+    UART0_Init();              // Profile dumps go out on UART0 TX.
+    Profile_Init();
+#endif
 
-    // Threshold adjustment phase: allow the user to select the minimum price value.
-    LCD_Clear();               // Clear the LCD screen.
-    LCD_Set_Cursor(0, 0);      // Set the cursor to the first column of the first row.
-    LCD_Display_String("Set min val:");  // Display the prompt to set the minimum value.
-    
-    // Format and display the initial threshold value using a fixed field width.
-    // "$%-7d" formats the number as left-justified in a field of 7 characters,
-    // ensuring that previous characters are overwritten on the LCD.
-    sprintf(threshStr, "$%-7d", thresholds[adjustable_index]);
-    LCD_Set_Cursor(0, 1);      // Set the cursor to the first column of the second row.
-    LCD_Display_String(threshStr);  // Display the threshold string.
-    
-    // Wait for 4 seconds while monitoring the push button to allow the user to adjust the threshold.
-    while (elapsed < 4000) {   // 4000 milliseconds = 4 seconds.
-        if (PushButton_Pressed()) {  
-            // If the button is pressed, cycle to the next threshold.
-            adjustable_index = (adjustable_index + 1) % total_thresholds;
-            // Use modulo to wrap the index when reaching the end of the thresholds array.
-            sprintf(threshStr, "$%-7d", thresholds[adjustable_index]);
-            // Format the new threshold value.
-            LCD_Set_Cursor(0, 1);      // Set the cursor to the second row.
-            LCD_Display_String(threshStr);  // Update the LCD with the new threshold.
-            elapsed = 0;           // Reset the elapsed time to allow further adjustments.
-            DelayMs(300);          // Wait 300 ms to debounce and avoid rapid cycling.
-        }
-        DelayMs(100);             // Delay 100 ms between checks.
-        elapsed += 100;           // Increment elapsed time by 100 ms.
+    // Warm start: with saved settings, go straight to the prices (last known ones, marked stale, until the
+    // ESP32 sends new ones). Holding the button at power-up opens the picker anyway.
+    if (Store_Load_Config(&adjustable_index, &threshold_rule)) {
+        if (adjustable_index >= total_thresholds)
+            adjustable_index = 0;
+        boot_hold = PushButton_Pressed();
+        phase = boot_hold ? PHASE_PICK : PHASE_RUN;
+    } else {
+        // Default alert rules (BTC); the threshold rule gets its level when the picker closes.
+        threshold_rule = Alert_Add(ALERT_BELOW, LINK_ASSET_BTC, 0, 0, 0, ALERT_HIGH);
+        Alert_Add(ALERT_MOVE, LINK_ASSET_BTC, MOVE_LEVEL_BP, MOVE_HYST_BP, MOVE_WINDOW_MS, ALERT_MEDIUM);
+        Alert_Add(ALERT_RATE, LINK_ASSET_BTC, RATE_LEVEL_BP, MOVE_HYST_BP, RATE_WINDOW_MS, ALERT_LOW);
     }
+    if (Store_Load_Cache() > 0)
+        page = Asset_Next_Valid(ASSET_MAX - 1);
 
-    // Save the selected threshold value into the global variable.
-    local_threshold = (float)thresholds[adjustable_index];  
-    // Convert the selected integer threshold to float.
-    
-    LCD_Clear();                // Clear the LCD.
-    LCD_Set_Cursor(0, 0);       // Set cursor to the first row.
-    LCD_Display_String("Threshold Saved");  // Inform the user that threshold is saved.
-    DelayMs(3000);              // Wait 3 seconds for the user to read the message.
-    LCD_Clear();                // Clear the LCD in preparation for the main loop.
-
-    // Main loop: continuously read UART data, parse price, and update the display/alerts.
-    while (1) {
-        char c = UART1_Input_Character();  // Get a character from UART.
-        // Check if we reached the end of a line (newline or carriage return) or the buffer is nearly full.
-        if ((c == '\n') || (c == '\r') || (index >= BUFFER_SIZE - 1)) {
-            uart_buffer[index] = '\0';    // Null-terminate the UART buffer to form a valid string.
-            // Parse the UART buffer expecting a format: "BTC Price: $<price>, 24h Change: <change>%"
-            if (sscanf(uart_buffer, "BTC Price: $%f, 24h Change: %f%%", &price, &change) == 2) {
-                // Extract the price and change percentage from the string into variables.
-                int intPrice = (int)price;  // Convert the float price to an integer for formatting.
-                int thousands = intPrice / 1000;  // Calculate the thousands part (integer division).
-                int remainder = intPrice % 1000;  // Calculate the remainder (modulo operation).
-                // Format the price and change to show thousands separated by a comma and a 2-decimal change.
-                sprintf(line2, "$%d,%03d  %+.2f%%", thousands, remainder, change);
-
-                // Check if the current price is below the user-selected threshold.
-                if (price < local_threshold) {
-                    // Continue alerting while price is below threshold and the user hasn't pressed the button.
-                    while (price < local_threshold && !PushButton_Pressed()) {
-                        LCD_Clear();      // Clear the display.
-                        char priceStr[17];  // Buffer for formatting the price string.
-                        sprintf(priceStr, "$%d,%03d", thousands, remainder);  // Format the price.
-                        LCD_Set_Cursor(0, 0);  // Set cursor on the first row.
-                        LCD_Display_String(priceStr);  // Display the formatted price.
-                        LCD_Set_Cursor(0, 1);  // Set cursor on the second row.
-                        LCD_Display_String("BUY NOW");  // Display the alert message.
-                        RGB_LED_Flash_Yellow();  // Flash the RGB LED to signal an alert.
-                        Buzzer_Toggle();   // Toggle the buzzer to generate an audible alert.
-                        DelayMs(150);      // Wait 150 ms between alert updates.
-                    }
-                    alarmStopped = 1;      // If the loop exits, assume the user has stopped the alarm.
-                    Buzzer_Off();          // Make sure the buzzer is turned off.
-                }
-                if (price >= local_threshold) {  
-                    // If the price is above the threshold, ensure the alarm flag is reset.
-                    alarmStopped = 0;
-                }
-
-                LCD_Clear();            // Clear the LCD.
-                LCD_Set_Cursor(0, 0);   // Set the cursor at the beginning of the first row.
-                LCD_Display_String("BTC Price:");  // Display a static label.
-                LCD_Set_Cursor(0, 1);   // Set the cursor at the beginning of the second row.
-                LCD_Display_String(line2);  // Display the formatted price and change string.
-                RGB_LED_Set_Normal(change); // Set the LED color according to the price change.
-                Buzzer_Off();         // Ensure the buzzer is off when no alert is needed.
-            } else {
-                // If the UART data doesn't match the expected format, display a "Loading..." message.
-                LCD_Clear();
-                LCD_Set_Cursor(0, 0);
-                LCD_Display_String("Loading...");
-                GPIOD->DATA &= ~0x03;  // Turn off the RGB LED.
-                Buzzer_Off();          // Turn off the buzzer.
-            }
-            index = 0;               // Reset the buffer index after processing a complete line.
-        } else {
-            uart_buffer[index++] = c;  // Append the received character to the buffer and increment the index.
-        }
+    // Register the periodic jobs; they run alongside UART parsing from the main loop.
+    Add_Job(Button_Job, BUTTON_SAMPLE_MS, 0);
+    Add_Job(Display_Job, DISPLAY_PERIOD_MS, 0);
+    Add_Job(Alert_Output_Job, ALERT_CADENCE_MS, 0);
+    page_job = Add_Job(Page_Job, PAGE_PERIOD_MS, PAGE_PERIOD_MS);
+    if (phase == PHASE_PICK)
+        phase_job = Add_Job(Phase_Timeout_Job, 0, PICK_TIMEOUT_MS);
+    Add_Job(Store_Job, STORE_PERIOD_MS, 0);
+    Add_Job(Cache_Save_Job, CACHE_CHECK_MS, CACHE_CHECK_MS);
+#ifdef TRACKER_PROFILE
+    Add_Job(Profile_Dump_Job, 1, 0);
+#endif
+    if (job_table_full) {
+        LCD_Buffer_Clear();
+        LCD_Printf_At(0, 0, "Job table full");
+        LCD_Commit();
     }
+}
+
+// One pass of the main loop: run due jobs, send one queued LCD byte and decode every received byte, then
+// sleep until the next interrupt if nothing is left to do. Nothing in here busy-waits.
+void Tracker_Poll(void) {
+    char c;                    // Byte received from the ESP32.
+    if (job_table_full) {
+        if (!LCD_Flush_Step())
+            __WFI();           // Only the message is shown; received bytes are left in the ring.
+        return;
+    }
+    Scheduler_Run();
+    if (LCD_Flush_Pending())
+        PROFILE_CALL(LCD_IO, LCD_Flush_Step());
+    while (UART1_Read_Character(&c))
+        Process_Byte(c);
+    if (!LCD_Flush_Pending())
+        Idle_Sleep();          // Nothing left until the next interrupt: the next job is at least a tick away.
+}
+
+#ifndef TRACKER_HOST           // The host simulator (tracker_sim.c) brings its own main and drives Tracker_Poll.
+int main(void) {
+    Tracker_Setup();
+    while (1)
+        Tracker_Poll();
     return 0;                    // End of main (in an embedded system, main usually never returns).
 }
+#endif
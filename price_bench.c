@@ -0,0 +1,288 @@
+//price_bench.c
+// Host fuzz test and throughput benchmark for the fixed-point parser and formatters in price_format.c,
+// measured against the sscanf/sprintf float code they replaced. Build:
+//   cc -O2 -DTRACKER_HOST -o price_bench price_bench.c price_format.c -lm
+// Usage:
+//   price_bench [-n lines] [-s seed]   Exits non-zero if any check fails
+//
+// Checks:
+//   exact    random well-formed price lines parse to exactly the cents and basis points written in them
+//   sscanf   the same lines give the same values as sscanf("%f") to within float precision
+//   mutated  corrupted lines never crash, and whenever Price_Parse_Line accepts one, sscanf accepts it too
+//            with the same values (sscanf alone also takes exponents, hex, inf/nan and out-of-range numbers)
+//   format   Price_Format_Dollars groups every three digits (or shows cents under $100), Price_Format_Change
+//            matches "%+.2f%%" and Price_Format_Line always fits one 16-character row
+
+#include "price_format.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LINE_MAX_LEN 96
+#define BENCH_LINES  1000         // Distinct lines in the throughput loops
+#define BENCH_ROUNDS 500          // Passes over them
+
+static int failures = 0;
+
+static double Now_Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void Fail(const char *check, const char *detail) {
+    if (failures++ < 10)
+        printf("FAIL %-8s %s\n", check, detail);
+}
+
+// Writes a random decimal number and returns its exact value in hundredths, rounded half away from zero on
+// the third decimal like the parser. 'max_whole' bounds the integer part; log-uniform so every length shows up.
+static int64_t Random_Number(char *out, int size, uint32_t max_whole, int allow_sign) {
+    uint32_t whole = (uint32_t)(pow((double)max_whole + 1, (double)rand() / RAND_MAX)) - 1;
+    int decimals = rand() % 6;    // 0 = no point at all
+    int negative = allow_sign && rand() % 2;
+    char frac[8] = "";
+    int len = snprintf(out, (size_t)size, "%s%lu", negative ? "-" : (allow_sign && rand() % 4 == 0) ? "+" : "",
+                       (unsigned long)whole);
+    for (int i = 0; i < decimals - 1; i++)
+        frac[i] = (char)('0' + rand() % 10);
+    frac[decimals > 0 ? decimals - 1 : 0] = '\0';
+    if (decimals > 0)
+        snprintf(out + len, (size_t)(size - len), ".%s", frac);
+    int64_t value = (int64_t)whole * 100;
+    if (frac[0])
+        value += (frac[0] - '0') * 10;
+    if (frac[0] && frac[1])
+        value += frac[1] - '0';
+    if (frac[0] && frac[1] && frac[2] >= '5')
+        value++;
+    return negative ? -value : value;
+}
+
+// Builds a well-formed line with the spacing variations sscanf accepts; returns the expected values.
+static void Random_Line(char *line, int32_t *cents, int32_t *change_bp) {
+    static const char *const spaces[] = { " ", "  ", "\t", " \t " };
+    char price[32], change[32];
+    *cents = (int32_t)Random_Number(price, sizeof(price), 21474835, 0);
+    *change_bp = (int32_t)Random_Number(change, sizeof(change), 999, 1);
+    snprintf(line, LINE_MAX_LEN, "BTC Price:%s$%s%s,%s24h Change:%s%s%s", spaces[rand() % 4],
+             rand() % 8 == 0 ? " " : "", price, spaces[rand() % 4], spaces[rand() % 4], change,
+             rand() % 4 ? "%" : "");
+}
+
+// The parser the firmware used before: float sscanf, as in the original main loop.
+static int Old_Parse(const char *line, float *price, float *change) {
+    return sscanf(line, "BTC Price: $%f, 24h Change: %f%%", price, change) == 2;
+}
+
+// A float holds about 7 significant digits: allow its spacing at this magnitude, plus the rounding step.
+static int Float_Agrees(float value, int32_t hundredths) {
+    double tolerance = 0.51 + fabs((double)value) * 100.0 / (1 << 23);
+    return fabs((double)value * 100.0 - hundredths) <= tolerance;
+}
+
+static void Check_Lines(int count) {
+    char line[LINE_MAX_LEN], detail[200];
+    int exact = 0, agree = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t want_cents, want_bp, cents = 0, bp = 0;
+        float price = 0, change = 0;
+        Random_Line(line, &want_cents, &want_bp);
+        if (!Price_Parse_Line(line, &cents, &bp) || cents != want_cents || bp != want_bp) {
+            snprintf(detail, sizeof(detail), "'%s' -> %ld / %ld, expected %ld / %ld", line, (long)cents, (long)bp,
+                     (long)want_cents, (long)want_bp);
+            Fail("exact", detail);
+        } else {
+            exact++;
+        }
+        if (!Old_Parse(line, &price, &change) || !Float_Agrees(price, want_cents) || !Float_Agrees(change, want_bp)) {
+            snprintf(detail, sizeof(detail), "'%s' -> sscanf %.4f / %.4f, expected %ld / %ld", line, price, change,
+                     (long)want_cents, (long)want_bp);
+            Fail("sscanf", detail);
+        } else {
+            agree++;
+        }
+    }
+    printf("exact    %d/%d well-formed lines parsed to the exact cents and basis points\n", exact, count);
+    printf("sscanf   %d/%d agree with sscanf(\"%%f\") within float precision\n", agree, count);
+}
+
+static void Mutate(char *line) {
+    static const char interesting[] = "0123456789.,-+ $%eExX\t\n:";
+    int len = (int)strlen(line);
+    for (int m = 1 + rand() % 4; m > 0 && len > 0; m--) {
+        int at = rand() % len;
+        char c = rand() % 2 ? interesting[rand() % (sizeof(interesting) - 1)] : (char)(1 + rand() % 255);
+        switch (rand() % 4) {
+        case 0:                   // Replace a byte.
+            line[at] = c;
+            break;
+        case 1:                   // Insert one.
+            if (len < LINE_MAX_LEN - 1) {
+                memmove(line + at + 1, line + at, (size_t)(len - at + 1));
+                line[at] = c;
+                len++;
+            }
+            break;
+        case 2:                   // Delete one.
+            memmove(line + at, line + at + 1, (size_t)(len - at));
+            len--;
+            break;
+        default:                  // Cut the line short.
+            line[at] = '\0';
+            len = at;
+            break;
+        }
+    }
+}
+
+static void Check_Mutated(int count) {
+    char line[LINE_MAX_LEN], detail[200];
+    int accepted = 0, old_only = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t cents, bp;
+        float price = 0, change = 0;
+        Random_Line(line, &cents, &bp);
+        Mutate(line);
+        int mine = Price_Parse_Line(line, &cents, &bp);
+        int old = Old_Parse(line, &price, &change);
+        if (mine && (!old || !Float_Agrees(price, cents) || !Float_Agrees(change, bp))) {
+            snprintf(detail, sizeof(detail), "'%s' -> %ld / %ld, sscanf %s %.4f / %.4f", line, (long)cents, (long)bp,
+                     old ? "took it as" : "rejected it", price, change);
+            Fail("mutated", detail);
+        }
+        accepted += mine;
+        old_only += old && !mine;
+    }
+    printf("mutated  %d corrupted lines: %d still well-formed, %d taken by sscanf alone (exponent, hex, inf/nan, range)\n",
+           count, accepted, old_only);
+}
+
+// Reference: whole dollars with a comma every three digits, or dollars and cents below PRICE_CENTS_BELOW.
+static void Grouped_Dollars(char *out, int32_t cents) {
+    char digits[16];
+    int n = snprintf(digits, sizeof(digits), "%ld", labs((long)cents) / 100), len = 0;
+    if (labs((long)cents) < PRICE_CENTS_BELOW) {
+        sprintf(out, "%s$%ld.%02ld", cents < 0 ? "-" : "", labs((long)cents) / 100, labs((long)cents) % 100);
+        return;
+    }
+    if (cents < 0)
+        out[len++] = '-';
+    out[len++] = '$';
+    for (int i = 0; i < n; i++) {
+        out[len++] = digits[i];
+        if ((n - 1 - i) % 3 == 0 && i < n - 1)
+            out[len++] = ',';
+    }
+    out[len] = '\0';
+}
+
+static void Check_Format(int count) {
+    char mine[32], want[32], detail[200];
+    int dollars_ok = 0, change_ok = 0, line_ok = 0, old_wrong = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t cents = (int32_t)(pow((double)PRICE_MAX_CENTS, (double)rand() / RAND_MAX));
+        int32_t bp = rand() % 65536 - 32768;  // Any int16 change, as frames carry.
+        if (rand() % 8 == 0)
+            cents = -cents;
+        Price_Format_Dollars(mine, sizeof(mine), cents);
+        Grouped_Dollars(want, cents);
+        if (strcmp(mine, want) != 0) {
+            snprintf(detail, sizeof(detail), "dollars %ld -> '%s', expected '%s'", (long)cents, mine, want);
+            Fail("format", detail);
+        } else {
+            dollars_ok++;
+        }
+        Price_Format_Change(mine, sizeof(mine), bp, 2);
+        snprintf(want, sizeof(want), "%+.2f%%", bp / 100.0);
+        if (strcmp(mine, want) != 0) {
+            snprintf(detail, sizeof(detail), "change %ld -> '%s', expected '%s'", (long)bp, mine, want);
+            Fail("format", detail);
+        } else {
+            change_ok++;
+        }
+        int len = Price_Format_Line(mine, sizeof(mine), cents, bp);
+        Price_Format_Dollars(want, sizeof(want), cents);
+        if (len > 16 || strncmp(mine, want, strlen(want)) != 0 || (len > (int)strlen(want) && !strchr(mine, '%'))) {
+            snprintf(detail, sizeof(detail), "line %ld %ld -> '%s'", (long)cents, (long)bp, mine);
+            Fail("format", detail);
+        } else {
+            line_ok++;
+        }
+        if (cents >= 0) {         // What the old "$%d,%03d" split printed for the same price.
+            int whole = (int)(cents / 100);
+            snprintf(mine, sizeof(mine), "$%d,%03d", whole / 1000, whole % 1000);
+            Grouped_Dollars(want, cents);
+            old_wrong += strcmp(mine, want) != 0;
+        }
+    }
+    printf("format   dollars %d/%d, change %d/%d, row fits %d/%d (old \"$%%d,%%03d\" split wrong for %d)\n",
+           dollars_ok, count, change_ok, count, line_ok, count, old_wrong);
+}
+
+static void Benchmark(void) {
+    static char lines[BENCH_LINES][LINE_MAX_LEN];
+    static int32_t cents[BENCH_LINES], bp[BENCH_LINES];
+    char out[32];
+    volatile int32_t sink = 0;
+    for (int i = 0; i < BENCH_LINES; i++)
+        Random_Line(lines[i], &cents[i], &bp[i]);
+    int n = BENCH_LINES * BENCH_ROUNDS;
+
+    double t0 = Now_Seconds();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_LINES; i++) {
+            int32_t c, b;
+            sink += Price_Parse_Line(lines[i], &c, &b) ? c : 0;
+        }
+    double t1 = Now_Seconds();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_LINES; i++) {
+            float p, c;
+            sink += Old_Parse(lines[i], &p, &c) ? (int32_t)p : 0;
+        }
+    double t2 = Now_Seconds();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_LINES; i++)
+            sink += Price_Format_Line(out, sizeof(out), cents[i], bp[i]);
+    double t3 = Now_Seconds();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_LINES; i++) {
+            int whole = (int)(cents[i] / 100);
+            float change = (float)bp[i] / 100.0f;
+            sink += snprintf(out, sizeof(out), "$%d,%03d  %+.2f%%", whole / 1000, whole % 1000, change);
+        }
+    double t4 = Now_Seconds();
+    (void)sink;
+
+    printf("\n%-36s %10s %12s\n", "throughput (host, -O2)", "ns/line", "lines/s");
+    printf("%-36s %10.1f %12.0f\n", "Price_Parse_Line", (t1 - t0) * 1e9 / n, n / (t1 - t0));
+    printf("%-36s %10.1f %12.0f  (%.1fx slower)\n", "sscanf(\"...$%f...%f%%\")", (t2 - t1) * 1e9 / n,
+           n / (t2 - t1), (t2 - t1) / (t1 - t0));
+    printf("%-36s %10.1f %12.0f\n", "Price_Format_Line", (t3 - t2) * 1e9 / n, n / (t3 - t2));
+    printf("%-36s %10.1f %12.0f  (%.1fx slower)\n", "snprintf(\"$%d,%03d  %+.2f%%\")", (t4 - t3) * 1e9 / n,
+           n / (t4 - t3), (t4 - t3) / (t3 - t2));
+}
+
+int main(int argc, char **argv) {
+    int count = 200000, opt;
+    unsigned seed = 1;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            count = atoi(optarg);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    srand(seed);
+    Check_Lines(count);
+    Check_Mutated(count);
+    Check_Format(count);
+    Benchmark();
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,152 @@
+//price_format.c
+
+#include "price_format.h"
+
+static int Is_Space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int Is_Digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Matches 'lit' at 's' the way a scanf format does: a space in 'lit' skips any whitespace (including none).
+static const char *Match_Literal(const char *s, const char *lit) {
+    for (; *lit; lit++) {
+        if (*lit == ' ') {
+            while (Is_Space(*s))
+                s++;
+        } else if (*s++ != *lit) {
+            return 0;
+        }
+    }
+    return s;
+}
+
+const char *Price_Parse_Fixed2(const char *s, int32_t *hundredths) {
+    uint32_t whole = 0;           // Integer part.
+    uint32_t frac = 0;            // First two fractional digits.
+    int digits = 0;               // Digits seen on either side of the point (%f needs at least one).
+    int negative = 0;
+    while (Is_Space(*s))
+        s++;                      // %f skips leading whitespace.
+    if (*s == '+' || *s == '-')
+        negative = (*s++ == '-');
+    for (; Is_Digit(*s); s++, digits++) {
+        whole = whole * 10 + (uint32_t)(*s - '0');
+        if (whole > PRICE_MAX_CENTS / 100)
+            return 0;             // Too large for 32-bit hundredths.
+    }
+    if (*s == '.') {
+        s++;
+        for (int place = 0; Is_Digit(*s); s++, place++, digits++) {
+            if (place < 2)
+                frac = frac * 10 + (uint32_t)(*s - '0');  // Keep hundredths...
+            else if (place == 2 && *s >= '5')
+                frac++;           // ...and round half away from zero on the third digit.
+            if (place == 0 && !Is_Digit(s[1]))
+                frac *= 10;       // Single fractional digit: ".5" is 50 hundredths.
+        }
+    }
+    if (digits == 0)
+        return 0;                 // No number here.
+    if (*s == 'e' || *s == 'E' || *s == 'x' || *s == 'X')
+        return 0;                 // Exponent or hex form: %f would read on and get a different value.
+    uint32_t value = whole * 100 + frac;
+    if (value > PRICE_MAX_CENTS)
+        return 0;
+    *hundredths = negative ? -(int32_t)value : (int32_t)value;
+    return s;
+}
+
+int Price_Parse_Line(const char *line, int32_t *cents, int32_t *change_bp) {
+    int32_t price_value, change_value;
+    const char *s = Match_Literal(line, "BTC Price: $");
+    if (!s || !(s = Price_Parse_Fixed2(s, &price_value)))
+        return 0;
+    if (!(s = Match_Literal(s, ", 24h Change: ")) || !Price_Parse_Fixed2(s, &change_value))
+        return 0;                 // The trailing '%' is not checked, just as sscanf's return value ignores it.
+    *cents = price_value;
+    *change_bp = change_value;
+    return 1;
+}
+
+// Writes 'value' in decimal into 'digits' (least significant first) and returns the digit count.
+static int Reverse_Digits(char *digits, uint32_t value) {
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return n;
+}
+
+int Price_Format_Dollars(char *out, int size, int32_t cents) {
+    char digits[10];
+    int len = 0;
+    uint32_t magnitude = (uint32_t)(cents < 0 ? -cents : cents);
+    int with_cents = magnitude < PRICE_CENTS_BELOW;
+    int n = Reverse_Digits(digits, with_cents ? magnitude : magnitude / 100);
+    while (with_cents && n < 3)
+        digits[n++] = '0';        // Leading zero(s): 5 cents is "$0.05".
+    if (size <= 0)
+        return 0;
+    if (cents < 0 && len < size - 1)
+        out[len++] = '-';
+    if (len < size - 1)
+        out[len++] = '$';
+    for (int i = n - 1; i >= 0 && len < size - 1; i--) {
+        out[len++] = digits[i];
+        if (with_cents && i == 2 && len < size - 1)
+            out[len++] = '.';
+        else if (!with_cents && i > 0 && i % 3 == 0 && len < size - 1)
+            out[len++] = ',';     // Group every three digits: $1,234,567.
+    }
+    out[len] = '\0';
+    return len;
+}
+
+int Price_Format_Change(char *out, int size, int32_t change_bp, int decimals) {
+    char digits[10];
+    int len = 0;
+    uint32_t magnitude = (uint32_t)(change_bp < 0 ? -change_bp : change_bp);
+    if (size <= 0)
+        return 0;
+    if (decimals < 2)
+        magnitude = (magnitude + (decimals == 1 ? 5 : 50)) / (decimals == 1 ? 10 : 100);  // Round half up.
+    else
+        decimals = 2;
+    int n = Reverse_Digits(digits, magnitude);
+    while (n <= decimals)
+        digits[n++] = '0';        // Leading zero(s): 5 bp is "0.05".
+    if (len < size - 1)
+        out[len++] = change_bp < 0 && magnitude ? '-' : '+';
+    for (int i = n - 1; i >= 0 && len < size - 1; i--) {
+        out[len++] = digits[i];
+        if (i == decimals && decimals > 0 && len < size - 1)
+            out[len++] = '.';
+    }
+    if (len < size - 1)
+        out[len++] = '%';
+    out[len] = '\0';
+    return len;
+}
+
+int Price_Format_Line(char *out, int size, int32_t cents, int32_t change_bp) {
+    char change[12];
+    int width = size - 1 < 16 ? size - 1 : 16;  // One LCD row.
+    int len = Price_Format_Dollars(out, size, cents);
+    for (int decimals = 2; decimals >= 0; decimals--) {
+        int change_len = Price_Format_Change(change, sizeof(change), change_bp, decimals);
+        int gap = (len + 2 + change_len <= width) ? 2 : 1;  // Two spaces as before, one if space is tight.
+        if (len + gap + change_len <= width) {
+            for (int i = 0; i < gap && len < size - 1; i++)
+                out[len++] = ' ';
+            for (int i = 0; change[i] && len < size - 1; i++)
+                out[len++] = change[i];
+            break;
+        }                         // Still too long without decimals (over $10M and 100 %): price only.
+    }
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,30 @@
+//price_format.h
+#ifndef PRICE_FORMAT_H            // Prevent multiple inclusions
+#define PRICE_FORMAT_H
+
+#include "tracker.h"              // int32_t
+
+// Fixed-point price handling: prices are kept in integer cents and percentages in basis points
+// (1 bp = 0.01 %), so neither parsing nor formatting needs floating point or the scanf/printf family.
+#define PRICE_MAX_CENTS 2147483647L   // Largest price that fits: $21,474,836.47
+#define PRICE_CENTS_BELOW 10000L      // Prices under $100 are shown with cents (whole dollars would be up to 1 % off)
+
+// Parses "BTC Price: $<price>, 24h Change: <change>%" in a single pass, accepting the same text as
+// sscanf("BTC Price: $%f, 24h Change: %f%%"): a space in the pattern matches any run of whitespace and the
+// trailing '%' is optional. Values are rounded half away from zero to 2 decimals.
+// Returns 1 and stores both values on success, 0 (outputs untouched) if the line does not match.
+int Price_Parse_Line(const char *line, int32_t *cents, int32_t *change_bp);
+
+// Parses a decimal number ("-12.345", "65000") into hundredths. Returns a pointer past the number or 0
+// (also for exponent or hex forms such as "1e3", which sscanf's %f would read as a different value).
+const char *Price_Parse_Fixed2(const char *s, int32_t *hundredths);
+
+// Formatters write a null-terminated string into 'out' (at most size - 1 characters) and return its length.
+int Price_Format_Dollars(char *out, int size, int32_t cents);
+// "$1,234,567" (whole dollars, truncated), or "$0.15" below PRICE_CENTS_BELOW.
+int Price_Format_Change(char *out, int size, int32_t change_bp, int decimals);  // "+1.23%" with 0-2 decimals
+int Price_Format_Line(char *out, int size, int32_t cents, int32_t change_bp);
+// "$65,000  +1.23%": price and change on one 16-character row; the change loses decimals if it would not fit
+// (and is left out if it does not fit even then).
+
+#endif // PRICE_FORMAT_H
@@ -0,0 +1,194 @@
+//profile.c
+
+#ifdef TRACKER_HOST
+#define _POSIX_C_SOURCE 199309L   // clock_gettime
+#include <time.h>
+#endif
+#include "profile.h"
+
+#ifdef TRACKER_PROFILE
+
+#include "link_protocol.h"        // Link_Crc16
+
+#define TRACE_MASK (PROFILE_TRACE_SIZE - 1)
+
+typedef struct {
+    uint32_t stamp;               // Reservation number + 1: the entry is still the one reserved as number n
+    uint8_t probe;
+    uint32_t start, duration;
+} Trace_Entry;
+
+Profile_Stats profile_stats[PROBE_COUNT];
+
+// Trace ring: producers (main loop and UART1_Handler) write a whole entry with interrupts masked, a few stores;
+// the dump, which UART1_Handler can interrupt, skips entries whose stamp shows they have been overwritten.
+static Trace_Entry trace[PROFILE_TRACE_SIZE];
+static volatile uint32_t trace_head = 0;  // Reservations so far
+static uint32_t epoch = 0;        // Profile_Now() at Profile_Init
+static uint64_t epoch_long = 0;   // Elapsed_Ticks() at Profile_Init
+
+#define PROBE_NAME(name, parent) #name,
+static const char *const probe_names[PROBE_COUNT] = { PROFILE_PROBE_LIST(PROBE_NAME) };
+#undef PROBE_NAME
+#define PROBE_PARENT(name, parent) PROBE_##parent,
+static const uint8_t probe_parents[PROBE_COUNT] = { PROFILE_PROBE_LIST(PROBE_PARENT) };
+#undef PROBE_PARENT
+
+static uint8_t dump[PROFILE_DUMP_MAX];  // Snapshot being sent
+static uint32_t dump_len = 0, dump_sent = 0;
+
+#ifdef TRACKER_HOST
+#define PROFILE_TICKS_PER_US 1000  // Host: nanoseconds
+#else
+#define PROFILE_TICKS_PER_US (SystemCoreClock / 1000000U)  // TM4C: core cycles
+#endif
+
+// Ticks since start-up without the 32-bit wrap (86 s on the TM4C), for the elapsed time in the dump.
+static uint64_t Elapsed_Ticks(void) {
+#ifdef TRACKER_HOST
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+#else
+    return (uint64_t)SysTick_Millis() * (SystemCoreClock / 1000U);
+#endif
+}
+
+void Profile_Init(void) {
+#ifndef TRACKER_HOST
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;  // Power the DWT unit.
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;             // Start counting core cycles.
+#endif
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        profile_stats[p] = (Profile_Stats){ 0 };
+        profile_stats[p].min = 0xFFFFFFFF;
+    }
+    trace_head = 0;
+    epoch = Profile_Now();
+    epoch_long = Elapsed_Ticks();
+}
+
+uint32_t Profile_Now(void) {
+#ifdef TRACKER_HOST
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+void Profile_Record(int probe, uint32_t start) {
+    uint32_t duration = Profile_Now() - start;
+    // Statistics: each probe is only ever recorded from one context, so plain updates are safe.
+    Profile_Stats *s = &profile_stats[probe];
+    s->count++;
+    s->total += duration;
+    if (duration < s->min)
+        s->min = duration;
+    if (duration > s->max)
+        s->max = duration;
+    int bucket = 0;
+    while (bucket < PROFILE_BUCKETS - 1 && (duration >> (bucket + 1)))
+        bucket++;
+    s->histogram[bucket]++;
+    // Trace: save and restore PRIMASK rather than enable, so a probe in a masked section leaves it masked.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t n = trace_head++;
+    Trace_Entry *e = &trace[n & TRACE_MASK];
+    e->stamp = n + 1;
+    e->probe = (uint8_t)probe;
+    e->start = start;
+    e->duration = duration;
+    __set_PRIMASK(primask);
+}
+
+static uint8_t *Put_U32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+void Profile_Dump_Start(void) {
+    if (dump_sent < dump_len)
+        return;                   // Previous dump still going out.
+    uint8_t *p = dump;
+    *p++ = 'P';
+    *p++ = 'R';
+    *p++ = 'F';
+    *p++ = PROFILE_VERSION;
+    *p++ = PROBE_COUNT;
+    *p++ = (uint8_t)PROFILE_TICKS_PER_US;
+    *p++ = (uint8_t)(PROFILE_TICKS_PER_US >> 8);
+    uint64_t elapsed = Elapsed_Ticks() - epoch_long;
+    p = Put_U32(p, (uint32_t)elapsed);
+    p = Put_U32(p, (uint32_t)(elapsed >> 32));
+    for (int probe = 0; probe < PROBE_COUNT; probe++) {
+        const Profile_Stats *s = &profile_stats[probe];
+        uint8_t len = 0;
+        while (probe_names[probe][len] && len < PROFILE_NAME_MAX)
+            len++;
+        *p++ = probe_parents[probe];
+        *p++ = len;
+        for (int i = 0; i < len; i++)
+            *p++ = (uint8_t)probe_names[probe][i];
+        p = Put_U32(p, s->count);
+        p = Put_U32(p, (uint32_t)s->total);
+        p = Put_U32(p, (uint32_t)(s->total >> 32));
+        p = Put_U32(p, s->count ? s->min : 0);
+        p = Put_U32(p, s->max);
+        for (int b = 0; b < PROFILE_BUCKETS; b++)
+            p = Put_U32(p, s->histogram[b]);
+    }
+    // Trace entries, oldest first; the count is patched in once the incomplete ones have been skipped.
+    uint8_t *count_at = p;
+    uint16_t count = 0;
+    p += 2;
+    uint32_t head = trace_head;
+    uint32_t first = head > PROFILE_TRACE_SIZE ? head - PROFILE_TRACE_SIZE : 0;
+    for (uint32_t n = first; n < head; n++) {
+        const Trace_Entry *e = &trace[n & TRACE_MASK];
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();          // Copy the entry in one piece: UART1_Handler may record over it.
+        Trace_Entry copy = *e;
+        __set_PRIMASK(primask);
+        if (copy.stamp != n + 1)
+            continue;             // Overwritten since head was read.
+        *p++ = copy.probe;
+        p = Put_U32(p, copy.start - epoch);
+        p = Put_U32(p, copy.duration);
+        count++;
+    }
+    count_at[0] = (uint8_t)count;
+    count_at[1] = (uint8_t)(count >> 8);
+    uint16_t crc = Link_Crc16(dump, (uint32_t)(p - dump));
+    *p++ = (uint8_t)crc;
+    *p++ = (uint8_t)(crc >> 8);
+    dump_len = (uint32_t)(p - dump);
+    dump_sent = 0;
+}
+
+void Profile_Dump_Job(void) {
+    while (dump_sent < dump_len && (UART0->FR & 0x20) == 0)  // TXFF (bit 5) clear: room in the TX FIFO.
+        UART0_DR_WRITE(dump[dump_sent++]);
+}
+
+void UART0_Init(void) {
+    SYSCTL->RCGCUART |= 0x01;     // Enable the UART0 module clock.
+    SYSCTL->RCGCGPIO |= 0x01;     // Enable the GPIO port clock for Port A (PA1 = U0TX).
+    while ((SYSCTL->PRGPIO & 0x01) == 0) { }  // Wait until Port A is ready.
+    UART0->CTL &= ~0x0001;        // Disable UART0 during configuration.
+    UART0->IBRD = 27;             // 115200 baud at 50 MHz, as for UART1.
+    UART0->FBRD = 8;
+    UART0->LCRH = (0x3 << 5) | (1 << 4);  // 8 data bits, FIFOs enabled.
+    UART0->CTL |= 0x0101;         // UARTEN and TXE: transmit only.
+    GPIOA->AFSEL |= 0x02;         // PA1 alternate function (PA2-PA5 stay LCD data lines).
+    GPIOA->PCTL = (GPIOA->PCTL & ~0xF0) | 0x10;
+    GPIOA->DEN |= 0x02;
+}
+
+#endif // TRACKER_PROFILE
@@ -0,0 +1,74 @@
+//profile.h
+// Cycle-count probes. Build with -DTRACKER_PROFILE to enable them; without it every PROFILE_* macro
+// expands to nothing and profile.c compiles to an empty unit, so the firmware is unchanged.
+// Counts come from the DWT cycle counter (CYCCNT, 50 per microsecond) on the TM4C and from
+// clock_gettime (nanoseconds) in host builds.
+#ifndef PROFILE_H                 // Prevent multiple inclusions
+#define PROFILE_H
+
+#include "tracker.h"              // uint32_t
+
+#define PROFILE_TRACE_SIZE 256    // Recent probe events kept in the trace ring (power of two)
+#define PROFILE_BUCKETS    16     // Histogram buckets: bucket n counts durations of 2^n to 2^(n+1)-1 ticks
+#define PROFILE_VERSION    1      // Dump format version
+
+// Probes as X(name, parent). The parent is the probe whose scope always encloses this one (NONE for
+// top-level scopes); the host decoder uses it to split each probe's time into its own and its children's.
+// UART_ISR preempts whatever is running, so its time is also counted inside the scope it interrupted.
+#define PROFILE_PROBE_LIST(X) \
+    X(UART_ISR,  NONE)    /* UART1_Handler: drain the RX FIFO into the ring */ \
+    X(PRICE,     NONE)    /* Process_Price: store a price, history, alerts */  \
+    X(HISTORY,   PRICE)   /* History_Add */                                    \
+    X(ALERTS,    PRICE)   /* Alert_Evaluate */                                 \
+    X(PARSE,     NONE)    /* Price_Parse_Line on a received text line */       \
+    X(DISPLAY,   NONE)    /* Display_Job redraw */                             \
+    X(FORMAT,    DISPLAY) /* Formatting the screen into the back buffer */     \
+    X(COMMIT,    DISPLAY) /* LCD_Commit: diff and queue the changed cells */   \
+    X(LCD_IO,    NONE)    /* LCD_Flush_Step with bytes pending (bus + waits) */
+
+#define PROFILE_PROBE_ENUM(name, parent) PROBE_##name,
+enum {
+    PROFILE_PROBE_LIST(PROFILE_PROBE_ENUM)
+    PROBE_COUNT,                  // Number of probes
+    PROBE_NONE = 0xFF             // Parent of top-level probes
+};
+#undef PROFILE_PROBE_ENUM
+
+#ifdef TRACKER_PROFILE
+
+// Dump layout (little-endian): "PRF", version, probe count, ticks per microsecond (u16), elapsed ticks
+// since Profile_Init (u32 low, u32 high); per probe: parent (u8), name length (u8), name, count, total low, total high,
+// min, max (u32 each) and PROFILE_BUCKETS histogram counts (u32); trace entry count (u16) and entries,
+// oldest first: probe (u8), start (u32), duration (u32); then CRC-16/CCITT-FALSE over everything before it.
+#define PROFILE_NAME_MAX 12      // Longest probe name in the dump
+#define PROFILE_DUMP_MAX (15 + PROBE_COUNT * (2 + PROFILE_NAME_MAX + 20 + 4 * PROFILE_BUCKETS) + 2 + PROFILE_TRACE_SIZE * 9 + 2)
+
+typedef struct {
+    uint32_t count;               // Completed scopes
+    uint64_t total;               // Sum of durations
+    uint32_t min, max;            // Shortest and longest duration
+    uint32_t histogram[PROFILE_BUCKETS];
+} Profile_Stats;
+
+extern Profile_Stats profile_stats[PROBE_COUNT];
+
+void Profile_Init(void);          // Start the cycle counter and clear all statistics
+uint32_t Profile_Now(void);       // Current tick count (wraps; compare with subtraction)
+void Profile_Record(int probe, uint32_t start);  // Close a scope opened at 'start'
+void Profile_Dump_Start(void);    // Snapshot the statistics and trace; Profile_Dump_Job sends it over UART0
+void Profile_Dump_Job(void);      // Scheduler job: move queued dump bytes into the UART0 TX FIFO
+void UART0_Init(void);            // UART0 transmit-only on PA1 at 115200 baud (the dump output)
+
+#define PROFILE_BEGIN(name) uint32_t profile_start_##name = Profile_Now()
+#define PROFILE_END(name) Profile_Record(PROBE_##name, profile_start_##name)
+#define PROFILE_CALL(name, stmt) do { PROFILE_BEGIN(name); stmt; PROFILE_END(name); } while (0)
+
+#else
+
+#define PROFILE_BEGIN(name)
+#define PROFILE_END(name)
+#define PROFILE_CALL(name, stmt) do { stmt; } while (0)
+
+#endif // TRACKER_PROFILE
+
+#endif // PROFILE_H
@@ -0,0 +1,193 @@
+//profile_decode.c
+// Host decoder for the probe dumps the firmware sends on UART0 when built with -DTRACKER_PROFILE (see
+// profile.h for the format). Reads a capture of the serial output, finds the dump and prints the per-probe
+// statistics and a flame-style breakdown of where the time went. Build:
+//   cc -O2 -o profile_decode profile_decode.c link_protocol.c
+// Usage:
+//   profile_decode [-f] [-t] capture.bin|-   -f: folded stacks for flamegraph.pl, -t: list the trace entries
+
+#include "link_protocol.h"        // Link_Crc16
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_PROBES  32
+#define MAX_BUCKETS 16            // PROFILE_BUCKETS in the firmware
+#define BAR_WIDTH   30
+
+typedef struct {
+    char name[16];
+    uint8_t parent;               // 0xFF: top level
+    uint32_t count, min, max;
+    uint64_t total;
+    uint32_t histogram[MAX_BUCKETS];
+} Probe;
+
+static Probe probes[MAX_PROBES];
+static int probe_count = 0;
+static uint32_t ticks_per_us = 1;
+static uint64_t elapsed = 0;
+
+static uint32_t Get_U32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static double Us(uint64_t ticks) {
+    return (double)ticks / ticks_per_us;
+}
+
+// Time spent in a probe's scope minus the time in its child scopes.
+static uint64_t Self_Time(int probe) {
+    uint64_t children = 0;
+    for (int c = 0; c < probe_count; c++)
+        if (probes[c].parent == probe)
+            children += probes[c].total;
+    return probes[probe].total > children ? probes[probe].total - children : 0;
+}
+
+static void Print_Bar(uint64_t part, uint64_t whole) {
+    int n = whole ? (int)(part * BAR_WIDTH / whole) : 0;
+    for (int i = 0; i < BAR_WIDTH; i++)
+        putchar(i < n ? '#' : ' ');
+}
+
+static void Print_Tree(int parent, int depth) {
+    for (int p = 0; p < probe_count; p++) {
+        if (probes[p].parent != parent)
+            continue;
+        printf("%*s%-*s %6.2f%% %6.2f%% |", depth * 2, "", 14 - depth * 2, probes[p].name,
+               elapsed ? 100.0 * probes[p].total / elapsed : 0.0, elapsed ? 100.0 * Self_Time(p) / elapsed : 0.0);
+        Print_Bar(probes[p].total, elapsed);
+        printf("|\n");
+        Print_Tree(p, depth + 1);
+    }
+}
+
+static void Print_Folded(int probe, char *stack, size_t len) {
+    for (int p = 0; p < probe_count; p++) {
+        if (probes[p].parent != probe)
+            continue;
+        size_t at = strlen(stack);
+        snprintf(stack + at, len - at, "%s%s", at ? ";" : "", probes[p].name);
+        printf("%s %.0f\n", stack, Us(Self_Time(p)));
+        Print_Folded(p, stack, len);
+        stack[at] = '\0';
+    }
+}
+
+int main(int argc, char **argv) {
+    int folded = 0, list_trace = 0, opt;
+    while ((opt = getopt(argc, argv, "ft")) != -1) {
+        if (opt == 'f')
+            folded = 1;
+        else if (opt == 't')
+            list_trace = 1;
+        else
+            return 2;
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-f] [-t] capture.bin|-\n", argv[0]);
+        return 2;
+    }
+    FILE *in = strcmp(argv[optind], "-") == 0 ? stdin : fopen(argv[optind], "rb");
+    if (!in) {
+        perror(argv[optind]);
+        return 1;
+    }
+    static uint8_t buf[1 << 20];
+    size_t size = fread(buf, 1, sizeof(buf), in);
+
+    // Use the last complete dump in the capture (the serial log may hold several, or other output).
+    const uint8_t *dump = 0;
+    size_t dump_len = 0;
+    for (size_t at = 0; at + 17 <= size; at++) {
+        if (memcmp(buf + at, "PRF", 3) != 0 || buf[at + 3] != 1 || buf[at + 4] > MAX_PROBES)
+            continue;
+        const uint8_t *p = buf + at + 15, *end = buf + size;
+        int ok = 1;
+        for (int i = 0; i < buf[at + 4] && ok; i++) {
+            if (p + 2 > end || p + 2 + p[1] + 20 + 4 * MAX_BUCKETS > end)
+                ok = 0;
+            else
+                p += 2 + p[1] + 20 + 4 * MAX_BUCKETS;
+        }
+        if (!ok || p + 2 > end)
+            continue;
+        p += 2 + 9 * (size_t)(p[0] | p[1] << 8);
+        if (p + 2 > end)
+            continue;
+        size_t len = (size_t)(p - (buf + at));
+        if (Link_Crc16(buf + at, (uint32_t)len) != (uint16_t)(p[0] | p[1] << 8))
+            continue;             // Corrupt or truncated.
+        dump = buf + at;
+        dump_len = len;
+    }
+    if (!dump) {
+        fprintf(stderr, "no valid profile dump found\n");
+        return 1;
+    }
+
+    const uint8_t *p = dump;
+    probe_count = p[4];
+    ticks_per_us = p[5] | p[6] << 8;
+    if (ticks_per_us == 0)
+        ticks_per_us = 1;
+    elapsed = Get_U32(p + 7) | (uint64_t)Get_U32(p + 11) << 32;
+    p += 15;
+    for (int i = 0; i < probe_count; i++) {
+        Probe *pr = &probes[i];
+        pr->parent = p[0];
+        int len = p[1] < sizeof(pr->name) - 1 ? p[1] : (int)sizeof(pr->name) - 1;
+        memcpy(pr->name, p + 2, (size_t)len);
+        p += 2 + p[1];
+        pr->count = Get_U32(p);
+        pr->total = Get_U32(p + 4) | (uint64_t)Get_U32(p + 8) << 32;
+        pr->min = Get_U32(p + 12);
+        pr->max = Get_U32(p + 16);
+        p += 20;
+        for (int b = 0; b < MAX_BUCKETS; b++, p += 4)
+            pr->histogram[b] = Get_U32(p);
+    }
+    int trace_count = p[0] | p[1] << 8;
+    p += 2;
+
+    if (folded) {
+        char stack[256] = "";
+        Print_Folded(0xFF, stack, sizeof(stack));
+        return 0;
+    }
+
+    printf("profile over %.3f ms (%u ticks/us), dump %zu bytes\n\n", Us(elapsed) / 1000, ticks_per_us, dump_len + 2);
+    printf("%-10s %9s %10s %10s %10s %12s  histogram (2^n ticks)\n", "probe", "count", "min us", "avg us",
+           "max us", "total us");
+    for (int i = 0; i < probe_count; i++) {
+        const Probe *pr = &probes[i];
+        printf("%-10s %9u %10.2f %10.2f %10.2f %12.1f  ", pr->name, pr->count, Us(pr->min),
+               pr->count ? Us(pr->total) / pr->count : 0.0, Us(pr->max), Us(pr->total));
+        uint32_t peak = 0;
+        for (int b = 0; b < MAX_BUCKETS; b++)
+            if (pr->histogram[b] > peak)
+                peak = pr->histogram[b];
+        for (int b = 0; b < MAX_BUCKETS; b++)
+            putchar(pr->histogram[b] == 0 ? '.' : " _.-=+*#%@"[1 + (int)(8ULL * pr->histogram[b] / peak)]);
+        putchar('\n');
+    }
+
+    printf("\n%-14s %7s %7s\n", "scope", "total", "self");
+    uint64_t roots = 0;
+    for (int i = 0; i < probe_count; i++)
+        if (probes[i].parent == 0xFF)
+            roots += probes[i].total;
+    Print_Tree(0xFF, 0);
+    printf("%-14s %6.2f%%  (outside every probe: idle polling, jobs without probes)\n", "other",
+           elapsed > roots ? 100.0 * (elapsed - roots) / elapsed : 0.0);
+
+    if (list_trace) {
+        printf("\nlast %d probe events:\n%12s %10s  probe\n", trace_count, "start us", "length us");
+        for (int i = 0; i < trace_count; i++, p += 9)
+            printf("%12.2f %10.2f  %s\n", Us(Get_U32(p + 1)), Us(Get_U32(p + 5)),
+                   p[0] < probe_count ? probes[p[0]].name : "?");
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+//scheduler.c
+
+#include "scheduler.h"
+
+typedef struct {
+    Job_Function fn;              // Function to run (NULL = free slot)
+    uint32_t period_ms;           // Repeat interval in milliseconds, 0 for one-shot jobs
+    uint32_t due_ms;              // SysTick_Millis() value at which the job should next run
+    uint32_t max_late_ms;         // Worst observed lateness, for jitter measurements
+    uint8_t armed;                // 1 while the job is waiting to run
+} Job;
+
+static Job jobs[SCHEDULER_MAX_JOBS];  // Job table, indexed by job id
+
+int Scheduler_Add(Job_Function fn, uint32_t period_ms, uint32_t delay_ms) {
+    for (int id = 0; id < SCHEDULER_MAX_JOBS; id++) {
+        if (jobs[id].fn == 0) {   // First free slot.
+            jobs[id].fn = fn;
+            jobs[id].period_ms = period_ms;
+            jobs[id].max_late_ms = 0;
+            Scheduler_Restart(id, delay_ms);
+            return id;
+        }
+    }
+    return -1;                    // Table full.
+}
+
+void Scheduler_Restart(int id, uint32_t delay_ms) {
+    if (id < 0 || id >= SCHEDULER_MAX_JOBS)
+        return;
+    jobs[id].due_ms = SysTick_Millis() + delay_ms;
+    jobs[id].armed = 1;
+}
+
+void Scheduler_Run(void) {
+    for (int id = 0; id < SCHEDULER_MAX_JOBS; id++) {
+        Job *job = &jobs[id];
+        if (!job->fn || !job->armed)
+            continue;
+        uint32_t now = SysTick_Millis();
+        int32_t late = (int32_t)(now - job->due_ms);  // Signed difference handles counter wrap-around.
+        if (late < 0)
+            continue;             // Not due yet.
+        if ((uint32_t)late > job->max_late_ms)
+            job->max_late_ms = (uint32_t)late;
+        if (job->period_ms) {
+            job->due_ms += job->period_ms;  // Stay on the original grid...
+            if ((int32_t)(now - job->due_ms) >= 0)
+                job->due_ms = now + job->period_ms;  // ...unless whole periods were missed: skip them instead of bursting.
+        } else {
+            job->armed = 0;       // One-shot: disarm before running so the job may re-arm itself.
+        }
+        job->fn();
+    }
+}
+
+uint32_t Scheduler_Max_Lateness(int id) {
+    if (id < 0 || id >= SCHEDULER_MAX_JOBS)
+        return 0;
+    return jobs[id].max_late_ms;
+}
@@ -0,0 +1,20 @@
+//scheduler.h
+#ifndef SCHEDULER_H               // Prevent multiple inclusions
+#define SCHEDULER_H
+
+#include "tracker.h"              // uint32_t and SysTick_Millis()
+
+#define SCHEDULER_MAX_JOBS 12     // Fixed job table size (no dynamic allocation)
+
+// A job is a short function that must return quickly: jobs run one after another from Scheduler_Run().
+typedef void (*Job_Function)(void);
+
+// Cooperative scheduler driven by the 1 ms SysTick counter.
+// Periodic jobs are rescheduled from their previous due time, so lateness in one run does not accumulate.
+int Scheduler_Add(Job_Function fn, uint32_t period_ms, uint32_t delay_ms);
+// Register 'fn' to run first after 'delay_ms', then every 'period_ms' (0 = one-shot). Returns a job id or -1 if full.
+void Scheduler_Restart(int id, uint32_t delay_ms);  // (Re)arm a job to run 'delay_ms' from now (e.g. to extend a timeout)
+void Scheduler_Run(void);                           // Run every job that is due; call this from the main loop
+uint32_t Scheduler_Max_Lateness(int id);            // Worst observed delay (ms) between a job's due time and its start
+
+#endif // SCHEDULER_H
@@ -0,0 +1,149 @@
+//scheduler_test.c
+// Host test for the cooperative scheduler in scheduler.c on the virtual clock of tm4c_host.c: registers
+// periodic and one-shot jobs that burn simulated CPU time, runs them from a main loop that also spends random
+// bursts "parsing", and checks how late each job starts. Build:
+//   cc -O2 -DTRACKER_HOST -o scheduler_test scheduler_test.c scheduler.c tracker.c tm4c_host.c
+// Usage:
+//   scheduler_test [-n seconds] [-s seed]   Exits non-zero if any check fails
+//
+// Checks:
+//   late     Scheduler_Max_Lateness of every job stays within one main loop pass (the other jobs' and the
+//            parser's worst case, rounded up to whole ticks, plus the tick it may start in)
+//   grid     each periodic job runs once per period over the run: lateness does not accumulate into drift
+//   oneshot  a one-shot job runs once, no earlier than its delay, and Scheduler_Restart pushes it back
+//   stall    after a 20 ms stall a periodic job runs once, then continues on the new grid: no catch-up burst
+
+#include "scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define JOBS          5
+#define PARSE_MAX_US  1500        // Longest burst of line parsing between two Scheduler_Run calls
+#define POLL_US       5           // Cost of an idle main loop pass
+#define STALL_MS      20
+
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t cost_us;             // Worst-case run time; each run takes a random share of it
+    int id;
+    uint32_t runs;
+    uint64_t last_us;             // Virtual time of the last run
+    uint64_t worst_us;            // Longest gap between two runs beyond the period (us), for the report
+} Test_Job;
+
+static Test_Job test_jobs[JOBS] = {
+    { .name = "button",  .period_ms = 10,   .cost_us = 30   },
+    { .name = "display", .period_ms = 50,   .cost_us = 900  },
+    { .name = "alert",   .period_ms = 125,  .cost_us = 120  },
+    { .name = "page",    .period_ms = 3000, .cost_us = 400  },
+    { .name = "store",   .period_ms = 1000, .cost_us = 2500 },
+};
+static int failures = 0;
+static int oneshot_id, oneshot_runs = 0;
+static uint64_t oneshot_due_us, oneshot_ran_us;
+
+static void Fail(const char *check, const char *name, long got, long want) {
+    if (failures++ < 10)
+        printf("FAIL %-8s %-8s %ld, expected %ld\n", check, name, got, want);
+}
+
+static void Job_Body(int j) {
+    Test_Job *t = &test_jobs[j];
+    uint64_t now = Host_Time_Us();
+    if (t->runs) {
+        uint64_t grid = t->last_us + (uint64_t)t->period_ms * 1000;
+        if (now > grid && now - grid > t->worst_us)
+            t->worst_us = now - grid;
+    }
+    t->runs++;
+    t->last_us = now;
+    Host_Advance_Us((uint32_t)(rand() % (t->cost_us + 1)));  // The job's own work.
+}
+
+static void Job_Button(void)  { Job_Body(0); }
+static void Job_Display(void) { Job_Body(1); }
+static void Job_Alert(void)   { Job_Body(2); }
+static void Job_Page(void)    { Job_Body(3); }
+static void Job_Store(void)   { Job_Body(4); }
+static const Job_Function bodies[JOBS] = { Job_Button, Job_Display, Job_Alert, Job_Page, Job_Store };
+
+static void Job_Oneshot(void) {
+    oneshot_runs++;
+    oneshot_ran_us = Host_Time_Us();
+}
+
+static void Main_Loop(uint64_t until_us) {
+    while (Host_Time_Us() < until_us) {
+        Scheduler_Run();
+        if (rand() % 4 == 0)
+            Host_Advance_Us((uint32_t)(rand() % (PARSE_MAX_US + 1)));  // A burst of received lines.
+        else
+            Host_Advance_Us(POLL_US);
+    }
+}
+
+int main(int argc, char **argv) {
+    uint32_t seconds = 600;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+        if (opt == 'n')
+            seconds = (uint32_t)strtoul(optarg, 0, 10);
+        else if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    srand(seed);
+    SysTick_Init();
+
+    // A job waits at most for one pass: every other job and one parse burst, plus the tick it becomes due in.
+    uint32_t pass_us = PARSE_MAX_US + POLL_US;
+    for (int j = 0; j < JOBS; j++) {
+        test_jobs[j].id = Scheduler_Add(bodies[j], test_jobs[j].period_ms, 0);
+        pass_us += test_jobs[j].cost_us;
+    }
+    uint32_t bound_ms = (pass_us + 999) / 1000 + 1;
+
+    // One-shot timeout, pushed back once before it fires (like the picker timeout after a button press).
+    oneshot_id = Scheduler_Add(Job_Oneshot, 0, 4000);
+    Main_Loop(Host_Time_Us() + 2000000);
+    Scheduler_Restart(oneshot_id, 4000);
+    oneshot_due_us = Host_Time_Us() + 4000000;
+    Main_Loop((uint64_t)seconds * 1000000);
+
+    printf("%lu s under load (parse bursts up to %d us), bound %lu ms\n\n", (unsigned long)seconds, PARSE_MAX_US,
+           (unsigned long)bound_ms);
+    printf("job      period ms  cost us    runs  max late ms  worst gap - period us\n");
+    for (int j = 0; j < JOBS; j++) {
+        Test_Job *t = &test_jobs[j];
+        uint32_t late = Scheduler_Max_Lateness(t->id);
+        uint32_t want = (uint32_t)((uint64_t)seconds * 1000 / t->period_ms);
+        printf("%-8s %9lu %8lu %7lu %12lu %22lu\n", t->name, (unsigned long)t->period_ms,
+               (unsigned long)t->cost_us, (unsigned long)t->runs, (unsigned long)late, (unsigned long)t->worst_us);
+        if (late > bound_ms)
+            Fail("late", t->name, (long)late, (long)bound_ms);
+        if (t->runs + 1 < want || t->runs > want + 1)
+            Fail("grid", t->name, (long)t->runs, (long)want);
+    }
+    if (oneshot_runs != 1)
+        Fail("oneshot", "runs", oneshot_runs, 1);
+    else if (oneshot_ran_us < oneshot_due_us - 1000 || oneshot_ran_us > oneshot_due_us + bound_ms * 1000)
+        Fail("oneshot", "at us", (long)oneshot_ran_us, (long)oneshot_due_us);
+    printf("%-8s %9s %8s %7d %12lu\n", "oneshot", "-", "-", oneshot_runs,
+           (unsigned long)Scheduler_Max_Lateness(oneshot_id));
+
+    // Stall the main loop for STALL_MS: the button job (10 ms) is due once, not STALL_MS / 10 times over.
+    Test_Job *b = &test_jobs[0];
+    Host_Advance_Us(STALL_MS * 1000);
+    uint32_t before = b->runs;
+    Main_Loop(Host_Time_Us() + (b->period_ms - 1) * 1000);
+    if (b->runs - before != 1)
+        Fail("stall", b->name, (long)(b->runs - before), 1);
+
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
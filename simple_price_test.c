@@ -0,0 +1,212 @@
+//simple_price_test.c
+// Host test for the batched fetch path of Bitcoin_tracker.ino: canned /simple/price bodies go through
+// json_stream.c with the same "<id>.usd", "<id>.usd_24h_change" and "<id>.last_updated_at" filter paths,
+// arriving in socket-sized chunks. The quotes are turned into price frames like sendPriceFrame() does and
+// decoded again with the TM4C's Link_Decoder. Build:
+//   cc -O2 -o simple_price_test simple_price_test.c json_stream.c link_protocol.c -lm
+// Usage:
+//   simple_price_test [-s seed] [dir]   Reads the canned bodies from dir (default: testdata in the directory
+//                                       of the binary); exits non-zero if any frame differs from the expected one
+
+#include "json_stream.h"
+#include "link_protocol.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FIELDS_PER_ASSET 3
+#define CHUNK_SIZE       64       // Socket read buffer in the sketch
+#define NOW              1716284500U  // Clock of the simulated ESP32 (stamps quotes without last_updated_at)
+#define BODY_MAX         4096
+
+// What the sketch builds in buildPriceRequest() and collects in onQuoteField().
+#define COINGECKO_ID(ticker, id) id,
+static const char *const asset_ids[LINK_ASSET_COUNT] = { LINK_ASSET_LIST(COINGECKO_ID) };
+#undef COINGECKO_ID
+static const char *const field_names[FIELDS_PER_ASSET] = { "usd", "usd_24h_change", "last_updated_at" };
+static char field_path_text[LINK_ASSET_COUNT * FIELDS_PER_ASSET][32];
+static const char *field_paths[LINK_ASSET_COUNT * FIELDS_PER_ASSET];
+
+typedef struct {
+    double price;
+    double change;
+    uint32_t updated;
+    uint8_t found;
+} Asset_Quote;
+
+// Expected frame per asset for each canned body; price_cents < 0 means no frame.
+typedef struct {
+    const char *file;             // Canned body, or the body itself when it starts with '{'
+    int32_t cents[LINK_ASSET_COUNT];
+    int16_t change[LINK_ASSET_COUNT];
+    uint32_t stamp[LINK_ASSET_COUNT];
+} Canned;
+
+static const Canned canned[] = {
+    // All ten assets, in CoinGecko's alphabetical order. LTC's 412.7 % is clamped, DOT's -0.005 % rounds
+    // away from zero and ADA's 1.2e-05 % is written with an exponent.
+    { "simple_price.json",
+      { 6723412, 378145, 17238, 52, 46, 15, 8507, 710, 1462, 12 },
+      { 243, 1988, -314, -87, 0, 250, 32767, -1, -120, 93 },
+      { 1716284487, 1716284490, 1716284484, 1716284479, 1716284461, 1716284470, 1716284402, 1716284433,
+        1716284455, 1716284412 } },
+    // TRX left out of the response (as for an unknown id) and LINK with only its price.
+    { "simple_price_partial.json",
+      { 6723412, 378145, 17238, 52, 46, 15, 8507, 710, 1462, -1 },
+      { 243, 1988, -314, -87, 0, 250, 32767, -1, 0, 0 },
+      { 1716284487, 1716284490, 1716284484, 1716284479, 1716284461, 1716284470, 1716284402, 1716284433,
+        NOW, 0 } },
+    // An error object served with status 200: nothing is sent.
+    { "{\"status\":{\"error_code\":429,\"error_message\":\"You've exceeded the Rate Limit.\"}}",
+      { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }, { 0 }, { 0 } },
+};
+
+static int failures = 0;
+
+static void Fail(const char *check, const char *detail) {
+    if (failures++ < 10)
+        printf("FAIL %-8s %s\n", check, detail);
+}
+
+static void Build_Paths(void) {
+    for (int i = 0; i < LINK_ASSET_COUNT; i++)
+        for (int f = 0; f < FIELDS_PER_ASSET; f++) {
+            int n = i * FIELDS_PER_ASSET + f;
+            snprintf(field_path_text[n], sizeof(field_path_text[n]), "%s.%s", asset_ids[i], field_names[f]);
+            field_paths[n] = field_path_text[n];
+        }
+}
+
+static void On_Quote_Field(void *ctx, int filter, const char *text) {
+    Asset_Quote *q = &((Asset_Quote *)ctx)[filter / FIELDS_PER_ASSET];
+    int field = filter % FIELDS_PER_ASSET;
+    if (field == 0)
+        q->price = strtod(text, 0);
+    else if (field == 1)
+        q->change = strtod(text, 0);
+    else
+        q->updated = (uint32_t)strtoul(text, 0, 10);
+    q->found |= (uint8_t)(1 << field);
+}
+
+// readJsonFields(): chunks of 1 to CHUNK_SIZE bytes, stopping once every field has been seen. Returns 1 if
+// any field was found, as the sketch does; 'read' is set to the bytes consumed.
+static int Read_Fields(Json_Stream *js, const char *body, int len, int *read) {
+    int at = 0;
+    while (at < len) {
+        int n = 1 + rand() % CHUNK_SIZE;
+        if (n > len - at)
+            n = len - at;
+        for (int i = 0; i < n; i++) {
+            int result = Json_Stream_Feed(js, body[at++]);
+            *read = at;
+            if (result == JSON_ERROR)
+                return 0;
+            if (result == JSON_DONE)
+                return 1;
+        }
+        if (Json_Stream_All_Found(js))
+            return 1;
+    }
+    return js->found != 0;
+}
+
+// sendPriceFrame(): the same rounding and clamping, then the TM4C's decoder.
+static int Send_Frame(Link_Decoder *d, uint8_t *seq, int id, const Asset_Quote *q, Link_Price *out) {
+    uint8_t frame[LINK_MAX_FRAME];
+    Link_Price p;
+    p.asset_id = (uint8_t)id;
+    p.price_cents = (int32_t)llround(q->price * 100.0);
+    long bp = lround(q->change * 100.0);
+    p.change_bp = (int16_t)(bp > 32767 ? 32767 : bp < -32768 ? -32768 : bp);
+    p.timestamp = q->updated ? q->updated : NOW;
+    int len = Link_Encode_Price(frame, (*seq)++, &p);
+    for (int i = 0; i < len; i++)
+        if (Link_Decoder_Feed(d, frame[i]) == LINK_FRAME)
+            return Link_Decode_Price(d, out);
+    return 0;
+}
+
+static int Load(const char *dir, const char *name, char *body) {
+    char path[256];
+    if (name[0] == '{') {
+        snprintf(body, BODY_MAX, "%s", name);
+        return (int)strlen(body);
+    }
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    int len = (int)fread(body, 1, BODY_MAX, f);
+    fclose(f);
+    return len;
+}
+
+static void Check_Canned(const char *dir, const Canned *c) {
+    static char body[BODY_MAX];
+    Asset_Quote quotes[LINK_ASSET_COUNT];
+    Link_Decoder d;
+    Json_Stream js;
+    char detail[200];
+    uint8_t seq = 0;
+    int len = Load(dir, c->file, body), read = 0, frames = 0, wrong = 0;
+    const char *name = c->file[0] == '{' ? "error body" : c->file;
+    if (len <= 0) {
+        snprintf(detail, sizeof(detail), "cannot read %s/%s", dir, c->file);
+        Fail("canned", detail);
+        return;
+    }
+    memset(quotes, 0, sizeof(quotes));
+    Link_Decoder_Init(&d);
+    Json_Stream_Init(&js, field_paths, LINK_ASSET_COUNT * FIELDS_PER_ASSET, On_Quote_Field, quotes);
+    int ok = Read_Fields(&js, body, len, &read);
+    for (int i = 0; i < LINK_ASSET_COUNT; i++) {
+        Link_Price p;
+        int sent = ok && (quotes[i].found & 1);  // fetchAndSendPrices() skips assets without a price.
+        if (!sent) {
+            if (c->cents[i] >= 0) {
+                snprintf(detail, sizeof(detail), "%s: no frame for %s", name, asset_ids[i]);
+                Fail("canned", detail);
+                wrong++;
+            }
+            continue;
+        }
+        frames++;
+        if (!Send_Frame(&d, &seq, i, &quotes[i], &p) || p.asset_id != i || p.price_cents != c->cents[i] ||
+            p.change_bp != c->change[i] || p.timestamp != c->stamp[i]) {
+            snprintf(detail, sizeof(detail), "%s: %s sent as %ld cents, %d bp, t=%lu; expected %ld, %d, %lu", name,
+                     asset_ids[i], (long)p.price_cents, p.change_bp, (unsigned long)p.timestamp, (long)c->cents[i],
+                     c->change[i], (unsigned long)c->stamp[i]);
+            Fail("canned", detail);
+            wrong++;
+        }
+    }
+    printf("%-26s %4d bytes, read %4d, %2d frames, %s\n", name, len, read, frames, wrong ? "WRONG" : "ok");
+}
+
+int main(int argc, char **argv) {
+    // Default: testdata next to the binary, so the test runs from any directory.
+    char dir_buf[160];
+    const char *slash = strrchr(argv[0], '/');
+    snprintf(dir_buf, sizeof(dir_buf), "%.*stestdata", slash ? (int)(slash - argv[0] + 1) : 0, argv[0]);
+    const char *dir = dir_buf;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:")) != -1) {
+        if (opt == 's')
+            seed = (unsigned)strtoul(optarg, 0, 10);
+        else
+            return 2;
+    }
+    if (optind < argc)
+        dir = argv[optind];
+    srand(seed);
+    Build_Paths();
+    for (unsigned i = 0; i < sizeof(canned) / sizeof(canned[0]); i++)
+        Check_Canned(dir, &canned[i]);
+    if (failures)
+        printf("\n%d check(s) failed\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,101 @@
+//tick_log.c
+
+#include "tick_log.h"
+#include <string.h>
+
+static int Put_Varint(uint8_t *out, int32_t value) {
+    uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);  // Zigzag: small magnitudes, small codes
+    int n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Reads a varint at in[*at]; returns 0 if it runs past 'len' or over 5 bytes.
+static int Get_Varint(const uint8_t *in, uint32_t len, uint32_t *at, int32_t *value) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*at >= len)
+            return 0;
+        uint8_t b = in[(*at)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int Tick_Log_Start(Tick_Log *log, uint8_t *out, uint32_t start, int with_header) {
+    int n = 0;
+    if (with_header) {
+        memcpy(out, "TKL", 3);
+        out[3] = TICK_LOG_VERSION;
+        n = TICK_LOG_HEADER_SIZE;
+    }
+    out[n++] = TICK_LOG_SEGMENT;
+    for (int i = 0; i < 4; i++)
+        out[n++] = (uint8_t)(start >> (8 * i));
+    memset(log->price, 0, sizeof(log->price));
+    log->start = start;
+    log->ms = 0;
+    log->segments++;
+    return n;
+}
+
+int Tick_Log_Encode(Tick_Log *log, uint8_t *out, uint32_t ms, const Link_Price *price) {
+    int id = price->asset_id;
+    int32_t previous = id < TICK_LOG_ASSETS ? log->price[id] : 0;
+    int n = 0;
+    out[n++] = id < TICK_LOG_SEGMENT ? (uint8_t)id : TICK_LOG_SEGMENT - 1;
+    n += Put_Varint(out + n, (int32_t)(ms - log->ms));
+    n += Put_Varint(out + n, (int32_t)((uint32_t)price->price_cents - (uint32_t)previous));
+    n += Put_Varint(out + n, price->change_bp);
+    log->ms = ms;
+    if (id < TICK_LOG_ASSETS)
+        log->price[id] = price->price_cents;
+    return n;
+}
+
+int Tick_Log_Check_Header(const uint8_t *in, uint32_t len) {
+    if (len < TICK_LOG_HEADER_SIZE || memcmp(in, "TKL", 3) != 0 || in[3] != TICK_LOG_VERSION)
+        return 0;
+    return TICK_LOG_HEADER_SIZE;
+}
+
+int Tick_Log_Decode(Tick_Log *log, const uint8_t *in, uint32_t len, uint32_t *ms, Link_Price *price) {
+    uint32_t at = 0;
+    while (at < len && in[at] == TICK_LOG_SEGMENT) {
+        if (len - at < TICK_LOG_SEGMENT_SIZE)
+            return -1;
+        uint32_t start = 0;
+        for (int i = 0; i < 4; i++)
+            start |= (uint32_t)in[at + 1 + i] << (8 * i);
+        uint8_t scratch[TICK_LOG_HEADER_SIZE + TICK_LOG_SEGMENT_SIZE];
+        Tick_Log_Start(log, scratch, start, 0);  // Same state reset as on the encoding side.
+        at += TICK_LOG_SEGMENT_SIZE;
+    }
+    if (at >= len)
+        return 0;
+    if (log->segments == 0)
+        return -1;                // Ticks before any segment marker.
+    int id = in[at++];
+    int32_t dt, dprice, change;
+    if (!Get_Varint(in, len, &at, &dt) || !Get_Varint(in, len, &at, &dprice) || !Get_Varint(in, len, &at, &change) ||
+        change < -32768 || change > 32767)
+        return -1;
+    log->ms += (uint32_t)dt;
+    int32_t cents = (int32_t)((uint32_t)(id < TICK_LOG_ASSETS ? log->price[id] : 0) + (uint32_t)dprice);
+    if (id < TICK_LOG_ASSETS)
+        log->price[id] = cents;
+    *ms = log->ms;
+    price->asset_id = (uint8_t)id;
+    price->price_cents = cents;
+    price->change_bp = (int16_t)change;
+    price->timestamp = log->start ? log->start + log->ms / 1000 : 0;
+    return (int)at;
+}
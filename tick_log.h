@@ -0,0 +1,54 @@
+//tick_log.h
+// Capture format for price ticks: the ESP32 sketch logs every price it sends, and the host replay
+// (tracker_sim -R) streams a capture back into the firmware. Plain C, like link_protocol.h, so the same
+// code builds into the sketches and the host tools.
+//
+// File layout: "TKL", TICK_LOG_VERSION, then records:
+//   TICK_LOG_SEGMENT (0xFF), start time (u32 little-endian, Unix seconds, 0 if unknown)
+//       Starts a segment (one per ESP32 power-up): tick times restart at 0 and previous prices are forgotten.
+//   asset id (u8, below 0xFF), then three zigzag varints (7 bits per byte, low group first, bit 7 = more):
+//       milliseconds since the previous tick in the segment, price change in cents from this asset's
+//       previous price in the segment (the full price the first time), 24h change in basis points.
+// A tick is typically 5-7 bytes, against 17 for a price frame.
+#ifndef TICK_LOG_H                // Prevent multiple inclusions
+#define TICK_LOG_H
+
+#include "link_protocol.h"        // Link_Price
+
+#ifdef __cplusplus
+extern "C" {                      // The ESP32 sketches are C++
+#endif
+
+#define TICK_LOG_VERSION      1
+#define TICK_LOG_SEGMENT      0xFF  // Record type byte of a segment start
+#define TICK_LOG_HEADER_SIZE  4     // "TKL" and the version
+#define TICK_LOG_SEGMENT_SIZE 5     // Segment marker and start time
+#define TICK_LOG_MAX_RECORD   14    // Longest tick record: asset id and three 32-bit varints (up to 5 bytes)
+#define TICK_LOG_ASSETS       32    // Asset ids with delta-coded prices; higher ids store the full price
+
+// Encoder or decoder state for one capture (zero-initialize it before first use).
+typedef struct {
+    uint32_t start;               // Unix seconds at the start of the current segment (0 if unknown)
+    uint32_t ms;                  // Milliseconds from the segment start to the last tick
+    uint32_t segments;            // Segments started so far
+    int32_t price[TICK_LOG_ASSETS];  // Last price of each asset in the segment (0 = none yet)
+} Tick_Log;
+
+int Tick_Log_Start(Tick_Log *log, uint8_t *out, uint32_t start, int with_header);
+// Begin a segment (and the file, if with_header): reset 'log' and write the header and segment marker
+// into 'out' (up to TICK_LOG_HEADER_SIZE + TICK_LOG_SEGMENT_SIZE bytes). Returns the byte count.
+int Tick_Log_Encode(Tick_Log *log, uint8_t *out, uint32_t ms, const Link_Price *price);
+// Write one tick taken 'ms' milliseconds after the segment start (up to TICK_LOG_MAX_RECORD bytes). The
+// price's timestamp field is not stored (it is start + ms / 1000). Returns the byte count.
+int Tick_Log_Check_Header(const uint8_t *in, uint32_t len);
+// Returns TICK_LOG_HEADER_SIZE if 'in' starts with a supported header, otherwise 0.
+int Tick_Log_Decode(Tick_Log *log, const uint8_t *in, uint32_t len, uint32_t *ms, Link_Price *price);
+// Decode the next tick after the header, passing over segment markers. Returns the bytes consumed (the
+// tick is in *ms and *price, timestamp included), 0 at the end of the data, or -1 if the record is
+// truncated or malformed.
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TICK_LOG_H
@@ -0,0 +1,384 @@
+//tm4c_host.c
+// Host-side models behind the register stand-in in tm4c_host.h. Only compiled for -DTRACKER_HOST builds.
+
+#include "tracker.h"
+
+GPIOA_Type Host_GPIOA, Host_GPIOB, Host_GPIOC, Host_GPIOD, Host_GPIOE;
+GPIOA_Type Host_GPIOF = { .DATA = 0x10 };             // PF4 button is pulled up (not pressed) at reset
+UART0_Type Host_UART0;
+UART0_Type Host_UART1 = { .FR = 0x10, .IFLS = 0x12 }; // RX FIFO empty, FIFO levels at their reset value
+SYSCTL_Type Host_SYSCTL = { .PRGPIO = 0x3F, .PRUART = 0xFF, .PREEPROM = 0x01 };  // Peripherals report ready immediately
+SysTick_Type Host_SysTick;
+SCB_Type Host_SCB;                // ICSR PENDSTSET: SysTick expired while interrupts were masked
+EEPROM_Type Host_EEPROM = { .EESIZE = (HOST_EEPROM_WORDS / 16) << 16 | HOST_EEPROM_WORDS };
+
+static int primask = 0;           // Modeled PRIMASK: 1 while interrupts are globally disabled
+static uint32_t nvic_enabled = 0; // Bit n set when IRQ n is enabled
+static uint32_t nvic_pending = 0; // Bit n set when IRQ n is waiting for delivery
+
+static uint64_t host_time_us = 0; // Virtual time since start-up
+static int host_woken = 0;        // Set whenever an interrupt is raised (ends __WFI)
+
+static uint16_t uart1_fifo[HOST_UART_FIFO_DEPTH];  // Modeled RX FIFO (byte plus error bits)
+static uint32_t uart1_fifo_head = 0, uart1_fifo_tail = 0;
+static uint32_t uart1_overrun_pending = 0;         // OE bit to attach to the next byte that fits
+
+static void Host_Deliver_Interrupts(void) {
+    // Deliver pending, enabled interrupts while PRIMASK is clear. Handlers may receive new bytes.
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) || (nvic_pending & nvic_enabled))
+        host_woken = 1;           // An interrupt is pending: a WFI in progress returns, even with PRIMASK set.
+    if (!primask && (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+        SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+        SysTick_Handler();
+    }
+    while (!primask && (nvic_pending & nvic_enabled)) {
+        if (nvic_pending & nvic_enabled & (1U << UART1_IRQn)) {
+            nvic_pending &= ~(1U << UART1_IRQn);
+            UART1_Handler();
+        }
+        if (nvic_pending & nvic_enabled & (1U << GPIOF_IRQn)) {
+            nvic_pending &= ~(1U << GPIOF_IRQn);
+            GPIOF_Handler();
+        }
+    }
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq) {
+    nvic_enabled |= 1U << irq;
+    Host_Deliver_Interrupts();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq) {
+    nvic_enabled &= ~(1U << irq);
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    (void)irq;                    // Priorities do not matter: the host model never nests handlers.
+    (void)priority;
+}
+
+void __enable_irq(void) {
+    primask = 0;
+    Host_Deliver_Interrupts();
+}
+
+void __disable_irq(void) {
+    primask = 1;
+}
+
+uint32_t __get_PRIMASK(void) {
+    return (uint32_t)primask;
+}
+
+void __set_PRIMASK(uint32_t value) {
+    primask = (int)(value & 1);
+    if (!primask)
+        Host_Deliver_Interrupts();
+}
+
+// UART1 wire model: bytes queued by Host_UART1_Send arrive one character time apart (10 bits at the baud).
+#define WIRE_SIZE 65536           // Bytes that can be queued on the wire
+static uint8_t wire_byte[WIRE_SIZE];
+static uint64_t wire_at_us[WIRE_SIZE];     // Arrival time of each queued byte
+static uint32_t wire_head = 0, wire_tail = 0;
+static uint32_t wire_baud = 115200;
+static uint64_t wire_free_ns = 0;          // When the last queued byte has finished arriving
+static uint64_t rx_timeout_us = UINT64_MAX;  // When the receive timeout fires (32 bit times after a byte)
+
+static uint64_t tick_due_us = 1000;        // Next whole millisecond boundary
+static uint64_t eeprom_busy_until_us = 0;  // End of the EEPROM word write in progress
+
+static void Host_Advance_To(uint64_t end) {
+    while (host_time_us < end) {
+        uint64_t next = tick_due_us;
+        if (wire_tail != wire_head && wire_at_us[wire_tail % WIRE_SIZE] < next)
+            next = wire_at_us[wire_tail % WIRE_SIZE];
+        if (rx_timeout_us < next)
+            next = rx_timeout_us;
+        if (next > end) {
+            host_time_us = end;
+            break;
+        }
+        if (next > host_time_us)
+            host_time_us = next;
+        if (wire_tail != wire_head && wire_at_us[wire_tail % WIRE_SIZE] <= host_time_us) {
+            Host_UART1_Receive(wire_byte[wire_tail++ % WIRE_SIZE]);
+            rx_timeout_us = host_time_us + 32000000ULL / wire_baud;
+        } else if (rx_timeout_us <= host_time_us) {
+            rx_timeout_us = UINT64_MAX;
+            Host_UART1_Line_Idle();
+        } else {
+            tick_due_us += 1000;
+            if ((SysTick->CTRL & 0x3) == 0x3) {  // ENABLE and TICKINT set: the SysTick exception fires.
+                SysTick->CTRL |= 1U << 16;         // COUNTFLAG
+                SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+                Host_Deliver_Interrupts();
+            }
+        }
+    }
+    EEPROM->EEDONE = host_time_us < eeprom_busy_until_us;  // WORKING until the last word write has finished.
+    // Mirror the down-counter so code that samples VAL sees the position within the current millisecond.
+    SysTick->VAL = SysTick->LOAD - (uint32_t)(host_time_us % 1000) * (SysTick->LOAD + 1) / 1000;
+}
+
+void Host_Advance_Us(uint32_t us) {
+    Host_Advance_To(host_time_us + us);
+}
+
+void Host_UART1_Set_Baud(uint32_t baud) {
+    wire_baud = baud ? baud : 1;
+}
+
+uint32_t Host_UART1_Send(const uint8_t *data, uint32_t len) {
+    uint64_t byte_ns = 10000000000ULL / wire_baud;  // Start bit, 8 data bits, stop bit
+    if (wire_free_ns < host_time_us * 1000)
+        wire_free_ns = host_time_us * 1000;        // Line was idle: the first byte starts now.
+    uint32_t sent = 0;
+    for (; sent < len && wire_head - wire_tail < WIRE_SIZE; sent++) {
+        wire_free_ns += byte_ns;
+        wire_byte[wire_head % WIRE_SIZE] = data[sent];
+        wire_at_us[wire_head % WIRE_SIZE] = (wire_free_ns + 999) / 1000;  // Complete once the stop bit is in.
+        wire_head++;
+    }
+    return sent;
+}
+
+uint64_t Host_UART1_Wire_Done_Us(void) {
+    return (wire_free_ns + 999) / 1000;
+}
+
+uint64_t Host_Time_Us(void) {
+    return host_time_us;
+}
+
+void __WFI(void) {
+    // Step from event to event (SysTick, wire byte, receive timeout) until one of them raises an interrupt.
+    // Idle periods without SysTick are cut off after a second so a misconfigured build cannot hang.
+    uint64_t limit = host_time_us + 1000000;
+    host_woken = 0;
+    while (!host_woken && host_time_us < limit) {
+        uint64_t next = tick_due_us;
+        if (wire_tail != wire_head && wire_at_us[wire_tail % WIRE_SIZE] < next)
+            next = wire_at_us[wire_tail % WIRE_SIZE];
+        if (rx_timeout_us < next)
+            next = rx_timeout_us;
+        if (next <= host_time_us)
+            next = host_time_us + 1;  // Due now but not yet handled (an advance stopped right on it).
+        Host_Advance_To(next < limit ? next : limit);
+    }
+}
+
+static uint32_t Host_UART1_Rx_Trigger(void) {
+    // IFLS RXIFLSEL (bits 3-5): 0 = 1/8, 1 = 1/4, 2 = 1/2, 3 = 3/4, 4 = 7/8 of the 16-entry FIFO.
+    static const uint32_t levels[] = { 2, 4, 8, 12, 14 };
+    uint32_t sel = (UART1->IFLS >> 3) & 0x7;
+    return levels[sel < 5 ? sel : 4];
+}
+
+static void Host_UART1_Raise(uint32_t ris) {
+    // ICR writes cannot be intercepted, so RIS holds only the most recent event instead of accumulating.
+    UART1->RIS = ris;
+    UART1->MIS = UART1->RIS & UART1->IM;
+    if (UART1->MIS) {
+        nvic_pending |= 1U << UART1_IRQn;
+        Host_Deliver_Interrupts();
+    }
+}
+
+void Host_UART1_Receive_Error(uint8_t byte, uint32_t flags) {
+    if ((UART1->CTL & 0x0201) != 0x0201)
+        return;                   // UART or receiver disabled: the byte is never sampled.
+    if (uart1_fifo_head - uart1_fifo_tail >= HOST_UART_FIFO_DEPTH) {
+        uart1_overrun_pending = 0x0800;  // FIFO full: the byte is lost and OE is flagged on the next one.
+        UART1->RSR |= 0x08;
+        Host_UART1_Raise(0x0400);
+        return;
+    }
+    uart1_fifo[uart1_fifo_head++ % HOST_UART_FIFO_DEPTH] = (uint16_t)(byte | (flags & 0x0700) | uart1_overrun_pending);
+    uart1_overrun_pending = 0;
+    UART1->FR &= ~0x10;           // RXFE clear: data available.
+    if (Host_UART1_Fifo_Level() >= Host_UART1_Rx_Trigger())
+        Host_UART1_Raise(0x10);   // RX level interrupt.
+}
+
+void Host_UART1_Line_Idle(void) {
+    if (Host_UART1_Fifo_Level() > 0)
+        Host_UART1_Raise(0x40);   // Receive timeout: data is waiting below the trigger level.
+}
+
+void Host_Button(int pressed) {
+    uint32_t before = GPIOF->DATA & 0x10;
+    GPIOF->DATA = pressed ? (GPIOF->DATA & ~0x10U) : (GPIOF->DATA | 0x10U);
+    if ((GPIOF->DATA & 0x10) == before)
+        return;
+    // Both-edges mode (IBE) or the configured edge (IEV: 1 = rising).
+    if ((GPIOF->IBE & 0x10) || ((GPIOF->IEV & 0x10) != 0) == !pressed) {
+        GPIOF->RIS |= 0x10;
+        GPIOF->MIS = GPIOF->RIS & GPIOF->IM;
+        if (GPIOF->MIS) {
+            nvic_pending |= 1U << GPIOF_IRQn;
+            Host_Deliver_Interrupts();
+        }
+    }
+}
+
+void Host_UART1_Receive(uint8_t byte) {
+    Host_UART1_Receive_Error(byte, 0);
+}
+
+uint32_t Host_UART1_Read_DR(void) {
+    if (uart1_fifo_head == uart1_fifo_tail)
+        return 0;                 // Reading an empty FIFO returns stale data on hardware; 0 is close enough.
+    uint32_t data = uart1_fifo[uart1_fifo_tail++ % HOST_UART_FIFO_DEPTH];
+    if (uart1_fifo_head == uart1_fifo_tail)
+        UART1->FR |= 0x10;        // RXFE set: FIFO drained.
+    return data;
+}
+
+uint32_t Host_UART1_Fifo_Level(void) {
+    return uart1_fifo_head - uart1_fifo_tail;
+}
+
+uint32_t host_eeprom[HOST_EEPROM_WORDS] = { [0 ... HOST_EEPROM_WORDS - 1] = 0xFFFFFFFF };  // Erased
+uint32_t host_eeprom_writes[HOST_EEPROM_WORDS];
+uint32_t host_eeprom_violations = 0;
+
+// Word addressed by EEBLOCK/EEOFFSET; EERDWRINC wraps the offset within the block, as on hardware.
+static uint32_t Host_EEPROM_Address(void) {
+    return (EEPROM->EEBLOCK * 16 + (EEPROM->EEOFFSET & 15)) % HOST_EEPROM_WORDS;
+}
+
+uint32_t Host_EEPROM_Read_Inc(void) {
+    uint32_t word = host_eeprom[Host_EEPROM_Address()];
+    EEPROM->EEOFFSET = (EEPROM->EEOFFSET + 1) & 15;
+    return word;
+}
+
+void Host_EEPROM_Write_Inc(uint32_t word) {
+    if (host_time_us < eeprom_busy_until_us) {
+        host_eeprom_violations++;  // The previous write is still programming: this one is lost.
+        return;
+    }
+    uint32_t address = Host_EEPROM_Address();
+    host_eeprom[address] = word;
+    host_eeprom_writes[address]++;
+    EEPROM->EEOFFSET = (EEPROM->EEOFFSET + 1) & 15;
+    eeprom_busy_until_us = host_time_us + HOST_EEPROM_WRITE_US;
+    EEPROM->EEDONE = 1;           // WORKING
+}
+
+static uint8_t uart0_tx[65536];   // Captured UART0 output not yet taken
+static uint32_t uart0_tx_len = 0;
+
+void Host_UART0_Write(uint32_t byte) {
+    if (uart0_tx_len < sizeof(uart0_tx))
+        uart0_tx[uart0_tx_len++] = (uint8_t)byte;
+}
+
+uint32_t Host_UART0_Take(uint8_t *out, uint32_t max) {
+    uint32_t n = uart0_tx_len < max ? uart0_tx_len : max;
+    for (uint32_t i = 0; i < n; i++)
+        out[i] = uart0_tx[i];
+    for (uint32_t i = n; i < uart0_tx_len; i++)
+        uart0_tx[i - n] = uart0_tx[i];
+    uart0_tx_len -= n;
+    return n;
+}
+
+// HD44780 model state.
+uint32_t host_lcd_violations = 0;
+uint32_t host_lcd_data_writes = 0;
+uint32_t host_lcd_commands = 0;
+static uint8_t lcd_ddram[0x80];           // Display data RAM (row 0 at 0x00, row 1 at 0x40)
+static uint8_t lcd_cgram[0x40];           // Character generator RAM (8 custom characters)
+static uint8_t lcd_ac = 0;                // Address counter
+static int lcd_cgram_mode = 0;            // 1 after "set CGRAM address" until "set DDRAM address"
+static int lcd_bus8 = 1;                  // The HD44780 powers up in 8-bit mode
+static int lcd_nibble = 0;                // 4-bit mode: 1 after the high nibble of a transfer
+static uint8_t lcd_high = 0;              // 4-bit mode: high nibble waiting for its low half
+static uint64_t lcd_busy_until = 15000;   // Internal reset runs for 15 ms after power-up
+static uint64_t lcd_rise_us = 0, lcd_fall_us = 0;  // Time of the last E edges (in us)
+static int lcd_rw = 0;                    // R/W sampled on the last rising edge
+
+static void Host_LCD_Execute(int rs, uint8_t value) {
+    uint64_t now = Host_Time_Us();
+    uint32_t exec_us = 37;
+    if (now < lcd_busy_until)
+        host_lcd_violations++;            // Written while the previous instruction was still executing.
+    if (rs) {
+        if (lcd_cgram_mode) {
+            lcd_cgram[lcd_ac & 0x3F] = value;
+            lcd_ac = (lcd_ac + 1) & 0x3F;
+        } else {
+            lcd_ddram[lcd_ac & 0x7F] = value;
+            // Two-line mode: 0x27 continues at 0x40 and 0x67 wraps back to 0x00.
+            lcd_ac = (lcd_ac == 0x27) ? 0x40 : (lcd_ac == 0x67) ? 0x00 : (uint8_t)(lcd_ac + 1);
+        }
+        host_lcd_data_writes++;
+        exec_us += 4;                     // tADD: the address counter updates 4 us after the write.
+    } else {
+        host_lcd_commands++;
+        if (value & 0x80) {               // Set DDRAM address.
+            lcd_ac = value & 0x7F;
+            lcd_cgram_mode = 0;
+        } else if (value & 0x40) {        // Set CGRAM address.
+            lcd_ac = value & 0x3F;
+            lcd_cgram_mode = 1;
+        } else if (value & 0x20) {        // Function set: DL (bit 4) selects the bus width.
+            lcd_bus8 = (value & 0x10) != 0;
+            lcd_nibble = 0;
+        } else if (value == 0x01) {       // Clear display.
+            for (int i = 0; i < 0x80; i++)
+                lcd_ddram[i] = ' ';
+            lcd_ac = 0;
+            lcd_cgram_mode = 0;
+            exec_us = 1520;
+        } else if (value <= 0x03) {       // Return home.
+            lcd_ac = 0;
+            lcd_cgram_mode = 0;
+            exec_us = 1520;
+        }                                 // Entry mode, display control and shift are accepted as-is.
+    }
+    lcd_busy_until = now + exec_us;
+}
+
+void Host_LCD_Enable(int level) {
+    uint64_t now = Host_Time_Us();
+    uint8_t bus = (uint8_t)(((GPIOA->DATA >> 2) & 0x0F) << 4) | (uint8_t)((GPIOE->DATA >> 2) & 0x0F);
+    int rs = GPIOE->DATA & 0x01;
+    if (level) {
+        if (lcd_fall_us && now - lcd_fall_us < 1)
+            host_lcd_violations++;        // Enable cycle shorter than 1 us.
+        lcd_rise_us = now;
+        lcd_rw = (GPIOE->DATA & 0x02) != 0;
+        if (lcd_rw) {
+            // Read: drive busy flag and address counter onto D7-D0 (the high nibble first in 4-bit mode).
+            uint8_t status = (uint8_t)((now < lcd_busy_until ? 0x80 : 0x00) | (lcd_ac & 0x7F));
+            uint8_t out = (!lcd_bus8 && lcd_nibble) ? (uint8_t)(status << 4) : status;
+            GPIOA->DATA = (GPIOA->DATA & ~0x3CU) | ((uint32_t)(out >> 4) << 2);
+            if (lcd_bus8)
+                GPIOE->DATA = (GPIOE->DATA & ~0x3CU) | ((uint32_t)(out & 0x0F) << 2);
+        }
+        return;
+    }
+    if (now - lcd_rise_us < 1)
+        host_lcd_violations++;            // Enable pulse narrower than 450 ns.
+    lcd_fall_us = now;
+    if (lcd_bus8) {
+        if (!lcd_rw)
+            Host_LCD_Execute(rs, bus);
+    } else if (!lcd_nibble) {
+        lcd_high = bus & 0xF0;            // 4-bit mode: D4-D7 carry the high nibble first.
+        lcd_nibble = 1;
+    } else {
+        lcd_nibble = 0;
+        if (!lcd_rw)
+            Host_LCD_Execute(rs, (uint8_t)(lcd_high | (bus >> 4)));
+    }
+}
+
+void Host_LCD_Row(int row, char *text) {
+    for (int i = 0; i < 16; i++)
+        text[i] = (char)lcd_ddram[(row ? 0x40 : 0x00) + i];
+    text[16] = '\0';
+}
@@ -0,0 +1,164 @@
+//tm4c_host.h
+// Register stand-in for building the tracker firmware on a Linux host (compile with -DTRACKER_HOST).
+// Each peripheral is a plain struct with the register names used by tracker.c, so the driver code is
+// unchanged. Behaviour that real hardware provides on its own (the UART1 RX FIFO, interrupt delivery)
+// is modeled in tm4c_host.c and driven by the Host_* functions below.
+#ifndef TM4C_HOST_H               // Prevent multiple inclusions
+#define TM4C_HOST_H
+
+#include <stdint.h>               // Fixed-width integer types normally pulled in by TM4C123GH6PM.h
+
+// GPIO port registers (only the ones the firmware touches).
+typedef struct {
+    volatile uint32_t DATA;       // Port data
+    volatile uint32_t DIR;        // Direction (1 = output)
+    volatile uint32_t IS;         // Interrupt sense
+    volatile uint32_t IBE;        // Interrupt both edges
+    volatile uint32_t IEV;        // Interrupt event
+    volatile uint32_t IM;         // Interrupt mask
+    volatile uint32_t RIS;        // Raw interrupt status
+    volatile uint32_t MIS;        // Masked interrupt status
+    volatile uint32_t ICR;        // Interrupt clear
+    volatile uint32_t AFSEL;      // Alternate function select
+    volatile uint32_t PUR;        // Pull-up select
+    volatile uint32_t PDR;        // Pull-down select
+    volatile uint32_t DEN;        // Digital enable
+    volatile uint32_t AMSEL;      // Analog mode select
+    volatile uint32_t PCTL;       // Port control (pin mux)
+} GPIOA_Type;
+
+// UART registers.
+typedef struct {
+    volatile uint32_t DR;         // Data (use UART1_DR_READ() to pop the RX FIFO)
+    volatile uint32_t RSR;        // Receive status / error clear
+    volatile uint32_t FR;         // Flags (bit 4 = RXFE, bit 5 = TXFF)
+    volatile uint32_t IBRD;       // Integer baud rate divisor
+    volatile uint32_t FBRD;       // Fractional baud rate divisor
+    volatile uint32_t LCRH;       // Line control
+    volatile uint32_t CTL;        // Control
+    volatile uint32_t IFLS;       // FIFO interrupt level select
+    volatile uint32_t IM;         // Interrupt mask
+    volatile uint32_t RIS;        // Raw interrupt status
+    volatile uint32_t MIS;        // Masked interrupt status
+    volatile uint32_t ICR;        // Interrupt clear
+} UART0_Type;
+
+// System control registers.
+typedef struct {
+    volatile uint32_t RCGCGPIO;   // GPIO run-mode clock gating
+    volatile uint32_t RCGCUART;   // UART run-mode clock gating
+    volatile uint32_t PRGPIO;     // GPIO peripheral ready
+    volatile uint32_t PRUART;     // UART peripheral ready
+    volatile uint32_t RCC;        // Run-mode clock configuration (bit 27 = ACG)
+    volatile uint32_t SCGCGPIO;   // GPIO sleep-mode clock gating
+    volatile uint32_t SCGCUART;   // UART sleep-mode clock gating
+    volatile uint32_t RCGCEEPROM; // EEPROM run-mode clock gating
+    volatile uint32_t SCGCEEPROM; // EEPROM sleep-mode clock gating
+    volatile uint32_t PREEPROM;   // EEPROM peripheral ready
+} SYSCTL_Type;
+
+// EEPROM registers (use EEPROM_READ_INC() / EEPROM_WRITE_INC() for the data register).
+typedef struct {
+    volatile uint32_t EESIZE;     // Size: words (bits 0-15) and blocks (bits 16-26)
+    volatile uint32_t EEBLOCK;    // Current block
+    volatile uint32_t EEOFFSET;   // Word offset within the current block (0-15)
+    volatile uint32_t EERDWRINC;  // Read/write the word at EEOFFSET, then advance EEOFFSET
+    volatile uint32_t EEDONE;     // Status (bit 0 = WORKING)
+    volatile uint32_t EESUPP;     // Support control and status (bits 2-3 = ERETRY, PRETRY)
+} EEPROM_Type;
+
+// SysTick registers.
+typedef struct {
+    volatile uint32_t CTRL;       // Control and status (bit 16 = COUNTFLAG)
+    volatile uint32_t LOAD;       // Reload value
+    volatile uint32_t VAL;        // Current value
+    volatile uint32_t CALIB;      // Calibration
+} SysTick_Type;
+
+// System control block: only the interrupt control and state register.
+typedef struct {
+    volatile uint32_t ICSR;       // Interrupt control and state (bit 26 = PENDSTSET: SysTick pending)
+} SCB_Type;
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+typedef enum {
+    UART1_IRQn = 6,               // UART1 interrupt number, as on the TM4C123GH6PM
+    GPIOF_IRQn = 30               // GPIO port F interrupt number
+} IRQn_Type;
+
+extern GPIOA_Type Host_GPIOA, Host_GPIOB, Host_GPIOC, Host_GPIOD, Host_GPIOE, Host_GPIOF;
+extern UART0_Type Host_UART0, Host_UART1;
+extern SYSCTL_Type Host_SYSCTL;
+extern SysTick_Type Host_SysTick;
+extern SCB_Type Host_SCB;
+extern EEPROM_Type Host_EEPROM;
+
+#define GPIOA   (&Host_GPIOA)
+#define GPIOB   (&Host_GPIOB)
+#define GPIOC   (&Host_GPIOC)
+#define GPIOD   (&Host_GPIOD)
+#define GPIOE   (&Host_GPIOE)
+#define GPIOF   (&Host_GPIOF)
+#define UART0   (&Host_UART0)
+#define UART1   (&Host_UART1)
+#define SYSCTL  (&Host_SYSCTL)
+#define SysTick (&Host_SysTick)
+#define SCB     (&Host_SCB)
+#define EEPROM  (&Host_EEPROM)
+
+// CMSIS core functions used by the firmware.
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+void __enable_irq(void);          // Clears the modeled PRIMASK and delivers any pending interrupts
+void __disable_irq(void);         // Sets the modeled PRIMASK (interrupts stay pending)
+uint32_t __get_PRIMASK(void);     // Modeled PRIMASK: 1 while interrupts are masked
+void __set_PRIMASK(uint32_t value); // Restores a saved PRIMASK; clearing it delivers pending interrupts
+void __WFI(void);                 // Sleeps until an interrupt is raised: advances virtual time event by event
+
+// Virtual clock: time only moves when the firmware waits (DelayUs, __WFI) or a test calls Host_Advance_Us.
+// Every whole millisecond crossed fires SysTick_Handler when SysTick is running with its interrupt enabled.
+void Host_Advance_Us(uint32_t us);      // Move virtual time forward by 'us' microseconds
+uint64_t Host_Time_Us(void);            // Virtual microseconds since start-up
+
+// Push button on PF4 (active low): updates the pin and raises the GPIOF interrupt if it is unmasked.
+void Host_Button(int pressed);
+
+// UART1 model: a 16-entry RX FIFO with the TM4C overrun behaviour.
+#define HOST_UART_FIFO_DEPTH 16
+void Host_UART1_Receive(uint8_t byte);  // A byte arrives on the wire (raises the RX interrupt if enabled)
+void Host_UART1_Receive_Error(uint8_t byte, uint32_t flags);  // Same, with FE/PE/BE bits (DR bits 8-10) set
+void Host_UART1_Line_Idle(void);       // The line went idle: raise the receive timeout if bytes are waiting
+uint32_t Host_UART1_Read_DR(void);      // Pop the RX FIFO (what reading UART1->DR does on hardware)
+uint32_t Host_UART1_Fifo_Level(void);   // Bytes currently held in the modeled RX FIFO
+// Wire model: bytes arrive one character time (10 bits) apart and raise the receive timeout 32 bit times
+// after the last one, as the virtual clock advances.
+void Host_UART1_Set_Baud(uint32_t baud);  // Line rate for Host_UART1_Send (default 115200)
+uint32_t Host_UART1_Send(const uint8_t *data, uint32_t len);
+// Queue bytes on the wire behind any still in flight. Returns how many fit (the wire holds 64 KB).
+uint64_t Host_UART1_Wire_Done_Us(void); // Virtual time at which the last queued byte has arrived
+
+// UART0 TX model: bytes written to DR (through UART0_DR_WRITE) are captured; the TX FIFO never fills.
+void Host_UART0_Write(uint32_t byte);   // A byte is written to UART0 DR
+uint32_t Host_UART0_Take(uint8_t *out, uint32_t max);  // Move up to 'max' captured bytes into out; returns the count
+
+// EEPROM model: 32 blocks of 16 words, erased to 0xFFFFFFFF. Each word write keeps EEDONE WORKING set for
+// HOST_EEPROM_WRITE_US of virtual time; a write issued while WORKING is set is lost (and counted).
+#define HOST_EEPROM_WORDS    512
+#define HOST_EEPROM_WRITE_US 110
+extern uint32_t host_eeprom[HOST_EEPROM_WORDS];         // Contents (load or save it to persist across runs)
+extern uint32_t host_eeprom_writes[HOST_EEPROM_WORDS];  // Program cycles per word (wear)
+extern uint32_t host_eeprom_violations;                 // Writes issued while the previous one was running
+uint32_t Host_EEPROM_Read_Inc(void);    // Read EERDWRINC: the word at EEBLOCK/EEOFFSET, then advance the offset
+void Host_EEPROM_Write_Inc(uint32_t word);  // Write EERDWRINC: program the word, then advance the offset
+
+// HD44780 model: watches the enable line (via LCD_BUS_TRACE), decodes 4- or 8-bit transfers, keeps DDRAM
+// and CGRAM, answers busy-flag reads and counts timing violations against the datasheet:
+// enable pulse < 450 ns, enable cycle < 1 us, or an instruction written while the previous one is executing.
+extern uint32_t host_lcd_violations;   // Timing violations seen so far
+extern uint32_t host_lcd_data_writes;  // Characters written (DDRAM or CGRAM)
+extern uint32_t host_lcd_commands;     // Instructions written
+void Host_LCD_Enable(int level);        // Called on every E edge with the new level
+void Host_LCD_Row(int row, char *text); // Copy the 16 visible characters of 'row' (0 or 1) into text[0..16]
+
+#endif // TM4C_HOST_H
@@ -1,25 +1,140 @@
 //tracker.c
 
 #include "tracker.h"            
+#include "profile.h"
 
-// Global variable definitions:
-float local_threshold = 0.0f;     // Initialize the threshold value used for comparisons to 0.0 (will be set later)
-int alarmStopped = 0;             // Initialize the alarm flag to 0 (alarm not stopped)
+// UART1 receive ring: single producer (UART1_Handler) / single consumer (main loop).
+// The indices are free-running counters; only the ISR writes 'head' and only the main loop writes 'tail',
+// so no locking is needed. The slot is always written before 'head' is advanced.
+#define UART1_RX_RING_MASK (UART1_RX_RING_SIZE - 1)
+static volatile uint8_t uart1_rx_ring[UART1_RX_RING_SIZE];  // Received bytes waiting for the main loop
+static volatile uint32_t uart1_rx_head = 0;   // Total bytes written by the ISR
+static volatile uint32_t uart1_rx_tail = 0;   // Total bytes consumed by the main loop
+volatile uint32_t uart1_rx_overruns = 0;      // Bytes dropped because the ring was full
+volatile uint32_t uart1_fifo_overruns = 0;    // Hardware RX FIFO overruns (OE bit)
+volatile uint32_t uart1_rx_errors = 0;        // Bytes dropped because of framing/parity/break errors
 
-// Delay routine: create a delay of 'ms' milliseconds.
-void DelayMs(uint32_t ms) {       
+// SysTick timer service:
+
+static volatile uint32_t systick_ms = 0;  // Milliseconds elapsed since SysTick_Init, advanced by SysTick_Handler
+
+void SysTick_Init(void) {
     SysTick->LOAD = (SystemCoreClock / 1000U) - 1;  
-    // Calculation: Each millisecond delay requires (SystemCoreClock / 1000) ticks.
+    // Calculation: Each millisecond requires (SystemCoreClock / 1000) ticks.
     // For a 50 MHz clock: (50,000,000 / 1000) = 50,000 ticks per millisecond. Subtract 1 because the timer counts from LOAD down to 0.
     SysTick->VAL = 0;           // Clear the current value register to start counting from LOAD value.
-    SysTick->CTRL = 5;          // Enable SysTick timer in processor clock mode (bit 0 = ENABLE, bit 2 = CLKSOURCE). No interrupt.
-    while(ms--) {               // Loop for the number of milliseconds
-        while((SysTick->CTRL & (1 << 16)) == 0) { } // Wait until the COUNTFLAG (bit 16) is set, meaning one millisecond has passed.
+    SysTick->CTRL = 7;          // Enable SysTick (bit 0) with its interrupt (bit 1) in processor clock mode (bit 2).
+}
+
+void SysTick_Handler(void) {
+    systick_ms++;               // One more millisecond has passed.
+}
+
+uint32_t SysTick_Millis(void) {
+    return systick_ms;
+}
+
+// Idle mode: the main loop sleeps in WFI whenever it has nothing to do and any interrupt (SysTick, UART1
+// receive, the PF4 button) wakes it. Sleep and active time are measured in SysTick clock ticks.
+
+uint64_t idle_sleep_ticks = 0;        // Clock ticks spent asleep since SysTick_Init
+uint32_t idle_wakes = 0;              // Times the core woke from Idle_Sleep
+volatile uint32_t idle_button_wakes = 0;  // Button edges seen by GPIOF_Handler
+
+// Clock ticks since SysTick_Init: whole milliseconds plus the part of the current one the counter has done.
+// Also correct with interrupts masked: a millisecond that has expired but not been handled is still pending.
+static uint64_t SysTick_Ticks(void) {
+    uint32_t ms, val, pending;
+    do {
+        ms = systick_ms;
+        pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+        val = SysTick->VAL;
+    } while (ms != systick_ms || pending != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));  // A tick in between: again.
+    if (pending)
+        ms++;
+    return (uint64_t)ms * (SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+
+void Idle_Init(void) {
+    // In sleep mode only the wake-up sources keep their clocks: UART1 and its pins on port B, and the
+    // button on port F. The LCD (ports A, C, E) and LED (port D) ports hold their outputs while gated.
+#ifdef TRACKER_PROFILE
+    // A profile dump goes out on UART0 (PA1) a FIFO at a time between wake-ups: keep it clocked as well.
+    SYSCTL->SCGCGPIO = 0x23;    // Ports A, B and F.
+    SYSCTL->SCGCUART = 0x03;    // UART0 and UART1.
+#else
+    SYSCTL->SCGCGPIO = 0x22;    // Ports B and F.
+    SYSCTL->SCGCUART = 0x02;    // UART1.
+#endif
+    SYSCTL->SCGCEEPROM = 0x01;  // EEPROM: a word program started before WFI must finish while asleep.
+    SYSCTL->RCC |= 1U << 27;    // ACG: use the sleep-mode gating registers while in WFI.
+}
+
+void Idle_Sleep(void) {
+    uint64_t start = SysTick_Ticks(), end = start;
+    __disable_irq();            // Check and sleep atomically: a byte arriving in between must not be slept through.
+    if (uart1_rx_head == uart1_rx_tail) {
+        __WFI();                // Wakes on any pending interrupt, even with PRIMASK set...
+        end = SysTick_Ticks();  // Sleep ends at the wake-up: the handler time after it counts as active.
     }
-    SysTick->CTRL = 0;          // Disable the SysTick timer after the delay.
+    __enable_irq();             // ...which is taken here.
+    idle_sleep_ticks += end - start;
+    idle_wakes++;
+}
+
+uint32_t Idle_Active_Permille(void) {
+    uint64_t total = SysTick_Ticks();
+    if (total == 0)
+        return 1000;
+    return (uint32_t)((total - idle_sleep_ticks) * 1000 / total);
+}
+
+// Delay routine: busy-wait 'us' microseconds without disturbing the 1 ms interrupt.
+void DelayUs(uint32_t us) {
+#ifdef TRACKER_HOST
+    Host_Advance_Us(us);        // Host build: move the virtual clock forward instead of spinning.
+#else
+    uint32_t reload = SysTick->LOAD + 1;                       // Ticks per SysTick period (50,000).
+    uint32_t remaining = us * (SystemCoreClock / 1000000U);    // 50 processor ticks per microsecond.
+    uint32_t last = SysTick->VAL;
+    while (remaining) {
+        uint32_t now = SysTick->VAL;
+        // SysTick counts down and reloads at 0, so account for a wrap between the two samples.
+        uint32_t elapsed = (last >= now) ? (last - now) : (last + reload - now);
+        if (elapsed >= remaining)
+            break;
+        remaining -= elapsed;
+        last = now;
+    }
+#endif
+}
+
+// Delay routine: create a delay of at least 'ms' milliseconds.
+void DelayMs(uint32_t ms) {       
+    uint32_t start = SysTick_Millis();
+    // Wait for ms + 1 tick edges: the first tick may arrive almost immediately after 'start' was sampled.
+    while ((SysTick_Millis() - start) <= ms)
+        __WFI();                // Sleep until the next interrupt (SysTick or UART1) instead of spinning.
 }
 
-// LCD initialization functions:
+// LCD (HD44780) driver:
+// Wiring: D4-D7 on PA2-PA5, E on PC6, RS on PE0. LCD_USE_BUSY_FLAG adds R/W on PE1 and
+// LCD_BUS_8BIT adds D0-D3 on PE2-PE5 (see tracker.h).
+
+// HD44780 timing from the datasheet (fosc = 270 kHz), rounded up to whole microseconds:
+#define LCD_ENABLE_HIGH_US 1      // PWEH >= 450 ns enable pulse width (also covers tDDR 360 ns for reads)
+#define LCD_ENABLE_LOW_US  1      // tcycE >= 1000 ns: keep E low long enough before the next pulse
+#define LCD_EXEC_US        40     // Most instructions and data writes complete in 37 us (+ tADD 4 us margin)
+#define LCD_CLEAR_US       1600   // Clear display and return home take 1.52 ms
+#define LCD_BUSY_TIMEOUT   2000   // Give up polling the busy flag after this many reads (panel missing)
+
+#ifdef LCD_BUS_8BIT
+#define LCD_PE_PINS 0x3F          // PE0 RS, PE1 R/W, PE2-PE5 D0-D3
+#elif defined(LCD_USE_BUSY_FLAG)
+#define LCD_PE_PINS 0x03          // PE0 RS, PE1 R/W
+#else
+#define LCD_PE_PINS 0x01          // PE0 RS (R/W tied to ground)
+#endif
 
 void LCD_Port_Init(void) {       
     SYSCTL->RCGCGPIO |= 0x01 | 0x04 | 0x10;  
@@ -32,15 +147,26 @@ void LCD_Port_Init(void) {
     GPIOA->DEN |= 0x3C;         // Enable digital function on PA2-PA5.
     GPIOC->DIR |= 0x40;         // Set PC6 as output (used for LCD enable pulse).
     GPIOC->DEN |= 0x40;         // Enable digital function on PC6.
-    GPIOE->DIR |= 0x01;         // Set PE0 as output (used for LCD RS, Register Select).
-    GPIOE->DEN |= 0x01;         // Enable digital function on PE0.
+    GPIOE->DIR |= LCD_PE_PINS;  // Set PE0 (RS) and, when configured, PE1 (R/W) and PE2-PE5 (D0-D3) as outputs.
+    GPIOE->DEN |= LCD_PE_PINS;  // Enable digital function on the same pins.
+    GPIOE->DATA &= ~LCD_PE_PINS;  // RS = 0, R/W = 0 (write).
+}
+
+static void LCD_Enable_High(void) {
+    GPIOC->DATA |= 0x40;        // Set PC6 high.
+    LCD_BUS_TRACE(1);           // Host build: let the HD44780 model see the rising edge.
+}
+
+static void LCD_Enable_Low(void) {
+    GPIOC->DATA &= ~0x40;       // Set PC6 low.
+    LCD_BUS_TRACE(0);           // Host build: the HD44780 model latches (or ends a read) on the falling edge.
 }
 
 void LCD_Pulse_Enable(void) {
-    GPIOC->DATA = (GPIOC->DATA & ~0xFF) | 0x40;  // Set PC6 high to generate an enable pulse for the LCD.
-    DelayMs(1);                  // Wait for 1 millisecond for the pulse to be recognized.
-    GPIOC->DATA = (GPIOC->DATA & ~0xFF) & ~0x40;   // Set PC6 low to complete the pulse.
-    DelayMs(1);                  // Wait 1 millisecond for settling.
+    LCD_Enable_High();          // Rising edge: the LCD samples RS and R/W.
+    DelayUs(LCD_ENABLE_HIGH_US);  // Hold E high for at least 450 ns.
+    LCD_Enable_Low();           // Falling edge: the LCD latches the data bus.
+    DelayUs(LCD_ENABLE_LOW_US); // Complete the 1 us enable cycle.
 }
 
 void LCD_Write_4_Bits(unsigned char nibble) {
@@ -49,18 +175,80 @@ void LCD_Write_4_Bits(unsigned char nibble) {
     LCD_Pulse_Enable();          // Pulse the enable signal to latch the data into the LCD.
 }
 
+#ifdef LCD_BUS_8BIT
+static void LCD_Write_8_Bits(unsigned char value) {
+    GPIOA->DATA = (GPIOA->DATA & ~0x3C) | ((value >> 4) << 2);     // D4-D7 on PA2-PA5.
+    GPIOE->DATA = (GPIOE->DATA & ~0x3C) | ((value & 0x0F) << 2);   // D0-D3 on PE2-PE5.
+    LCD_Pulse_Enable();          // One enable pulse transfers the whole byte.
+}
+#endif
+
+static void LCD_Write_Byte(unsigned char value) {
+#ifdef LCD_BUS_8BIT
+    LCD_Write_8_Bits(value);
+#else
+    LCD_Write_4_Bits(value >> 4);   // High nibble first.
+    LCD_Write_4_Bits(value & 0x0F); // Then the low nibble.
+#endif
+}
+
+#ifdef LCD_USE_BUSY_FLAG
+// Reads the busy flag (D7). Note: the TM4C pins are not 5 V tolerant, so reading requires a 3.3 V panel
+// or a level shifter on D4-D7.
+static int LCD_Read_Busy(void) {
+    int busy;
+    GPIOA->DIR &= ~0x3C;        // Release PA2-PA5 so the LCD can drive D4-D7.
+#ifdef LCD_BUS_8BIT
+    GPIOE->DIR &= ~0x3C;        // Release PE2-PE5 (D0-D3) too.
+#endif
+    GPIOE->DATA = (GPIOE->DATA & ~0x01) | 0x02;  // RS = 0, R/W = 1: read busy flag and address.
+    LCD_Enable_High();
+    DelayUs(LCD_ENABLE_HIGH_US);  // Data is valid tDDR (360 ns) after E rises.
+    busy = (GPIOA->DATA & 0x20) != 0;  // D7 (PA5) is the busy flag.
+    LCD_Enable_Low();
+    DelayUs(LCD_ENABLE_LOW_US);
+#ifndef LCD_BUS_8BIT
+    LCD_Pulse_Enable();         // 4-bit mode: clock out the low nibble (address counter) and ignore it.
+#endif
+    GPIOE->DATA &= ~0x02;       // R/W = 0: back to writing.
+    GPIOA->DIR |= 0x3C;         // Drive PA2-PA5 again.
+#ifdef LCD_BUS_8BIT
+    GPIOE->DIR |= 0x3C;
+#endif
+    return busy;
+}
+#endif
+
+// Waits until the LCD can accept the next instruction. With the busy flag this polls the panel;
+// otherwise the fixed execution time was already spent after the previous write.
+static void LCD_Wait_Ready(void) {
+#ifdef LCD_USE_BUSY_FLAG
+    int tries = LCD_BUSY_TIMEOUT;
+    while (tries-- && LCD_Read_Busy()) { }
+#endif
+}
+
+// Waits out the execution time of the instruction just written when the busy flag is not used.
+static void LCD_Wait_Exec(uint32_t us) {
+#ifdef LCD_USE_BUSY_FLAG
+    (void)us;                   // The next LCD_Wait_Ready() polls instead.
+#else
+    DelayUs(us);
+#endif
+}
+
 void LCD_Send_Command(unsigned char cmd) {
+    LCD_Wait_Ready();
     GPIOE->DATA &= ~0x01;       // Clear RS (Register Select) on PE0 to indicate a command.
-    LCD_Write_4_Bits(cmd >> 4);   // Send the high nibble (upper 4 bits) of the command.
-    LCD_Write_4_Bits(cmd & 0x0F); // Send the low nibble (lower 4 bits) of the command.
-    DelayMs(2);                  // Wait for 2 milliseconds for the command to process.
+    LCD_Write_Byte(cmd);
+    LCD_Wait_Exec(cmd <= 0x03 ? LCD_CLEAR_US : LCD_EXEC_US);  // Clear (0x01) and home (0x02/0x03) are slow.
 }
 
 void LCD_Send_Data(unsigned char data) {
+    LCD_Wait_Ready();
     GPIOE->DATA |= 0x01;        // Set RS (Register Select) on PE0 to indicate data.
-    LCD_Write_4_Bits(data >> 4);  // Send high nibble of data.
-    LCD_Write_4_Bits(data & 0x0F); // Send low nibble of data.
-    DelayMs(2);                  // Wait for 2 milliseconds to allow the data to be latched.
+    LCD_Write_Byte(data);
+    LCD_Wait_Exec(LCD_EXEC_US); // Data writes take 37 us.
 }
 
 void LCD_Set_Cursor(unsigned char col, unsigned char row) {
@@ -73,24 +261,35 @@ void LCD_Set_Cursor(unsigned char col, unsigned char row) {
 void LCD_Init(void) {
     LCD_Port_Init();            // Initialize the LCD GPIO ports.
     DelayMs(40);                // Wait 40 ms for LCD power up.
+    // Reset by instruction: three "function set 8-bit" writes with the datasheet's waits.
+    // The busy flag cannot be read until the interface width is known, so these use fixed delays.
+#ifdef LCD_BUS_8BIT
+    LCD_Write_8_Bits(0x30);
+    DelayUs(4100);              // Wait more than 4.1 ms.
+    LCD_Write_8_Bits(0x30);
+    DelayUs(100);               // Wait more than 100 us.
+    LCD_Write_8_Bits(0x30);
+    DelayUs(LCD_EXEC_US);
+    LCD_Send_Command(0x38);     // Function set: 8-bit, 2-line, 5x8 dots (0x38 = 0011 1000).
+#else
     LCD_Write_4_Bits(0x03);     // Send "0x03" to initialize in 8-bit mode (first step in initialization).
-    DelayMs(5);                 // Wait 5 ms.
+    DelayUs(4100);              // Wait more than 4.1 ms.
     LCD_Write_4_Bits(0x03);     // Repeat the 0x03 command.
-    DelayMs(1);                 // Wait 1 ms.
+    DelayUs(100);               // Wait more than 100 us.
     LCD_Write_4_Bits(0x03);     // Send 0x03 a third time.
-    DelayMs(1);                 // Wait 1 ms.
+    DelayUs(LCD_EXEC_US);
     LCD_Write_4_Bits(0x02);     // Send 0x02 to set the LCD to 4-bit mode.
+    DelayUs(LCD_EXEC_US);
     LCD_Send_Command(0x28);     // Function set: 4-bit, 2-line, 5x8 dots (0x28 = 0010 1000).
+#endif
     LCD_Send_Command(0x08);     // Display off command.
-    LCD_Send_Command(0x01);     // Clear display command.
-    DelayMs(2);                 // Wait 2 ms for the clear command to complete.
+    LCD_Send_Command(0x01);     // Clear display command (waits 1.52 ms).
     LCD_Send_Command(0x06);     // Entry mode set: increment automatically, no display shift.
     LCD_Send_Command(0x0C);     // Display on, cursor off command.
 }
 
 void LCD_Clear(void) {
-    LCD_Send_Command(0x01);     // Send the clear display command.
-    DelayMs(2);                 // Wait for 2 ms so that the display can clear.
+    LCD_Send_Command(0x01);     // Send the clear display command (the 1.52 ms wait is part of it).
 }
 
 void LCD_Display_String(const char *str) {
@@ -115,17 +314,57 @@ void UART1_Init(void) {
     UART1->FBRD = 8;            // Set the fractional baud rate divisor to 8.
     UART1->LCRH = (0x3 << 5) | (1 << 4);  
     // Set word length to 8 bits (0x3 << 5) and enable FIFOs (bit 4).
+    UART1->IFLS = (UART1->IFLS & ~0x38) | (0x1 << 3);
+    // Raise the RX interrupt when the FIFO is 1/4 full (4 bytes), leaving 12 bytes (~1 ms at 115200) of headroom.
+    UART1->ICR = 0x0450;        // Clear any stale RX (bit 4), RX timeout (bit 6) and overrun (bit 10) interrupts.
+    UART1->IM |= 0x0450;        // Unmask RX, RX timeout (catches the tail of a line) and overrun interrupts.
     UART1->CTL |= 0x0301;       // Enable UART1: set UARTEN (bit 0), TXE (bit 8), and RXE (bit 9).
 
     GPIOB->AFSEL |= 0x03;       // Enable alternate functions on PB0 and PB1 for UART.
     GPIOB->PCTL = (GPIOB->PCTL & ~0xFF) | 0x11;  
     // Configure PB0 and PB1 for UART (PCTL value 0x1 for each pin), preserving other bits.
     GPIOB->DEN |= 0x03;         // Enable digital functionality on PB0 and PB1.
+
+    NVIC_SetPriority(UART1_IRQn, 1);  // High priority: the FIFO must be drained before it overflows.
+    NVIC_EnableIRQ(UART1_IRQn);       // Enable the UART1 interrupt (IRQ 6) in the NVIC.
+    __enable_irq();                   // Make sure interrupts are globally enabled.
+}
+
+void UART1_Handler(void) {
+    PROFILE_BEGIN(UART_ISR);
+    UART1->ICR = 0x0450;        // Acknowledge RX, RX timeout and overrun interrupts before draining.
+    while ((UART1->FR & 0x10) == 0) {  // Drain until the Receive FIFO is empty (RXFE, bit 4).
+        uint32_t data = UART1_DR_READ();  // Bits 0-7 hold the byte, bits 8-11 hold FE, PE, BE and OE.
+        if (data & 0x0800)
+            uart1_fifo_overruns++;  // OE: the hardware FIFO overflowed before this byte; the byte itself is valid.
+        if (data & 0x0700) {
+            uart1_rx_errors++;      // FE/PE/BE: the byte is corrupt, drop it.
+            continue;
+        }
+        uint32_t head = uart1_rx_head;
+        if (head - uart1_rx_tail >= UART1_RX_RING_SIZE) {
+            uart1_rx_overruns++;    // Ring full: the main loop has fallen behind, drop the byte.
+            continue;
+        }
+        uart1_rx_ring[head & UART1_RX_RING_MASK] = (uint8_t)data;  // Store the byte before publishing it.
+        uart1_rx_head = head + 1;   // Publish the byte to the main loop.
+    }
+    PROFILE_END(UART_ISR);
+}
+
+int UART1_Read_Character(char *c) {
+    uint32_t tail = uart1_rx_tail;
+    if (tail == uart1_rx_head)
+        return 0;               // Ring is empty.
+    *c = (char)uart1_rx_ring[tail & UART1_RX_RING_MASK];  // Read the byte before releasing its slot.
+    uart1_rx_tail = tail + 1;   // Release the slot to the ISR.
+    return 1;
 }
 
 char UART1_Input_Character(void) {
-    while (UART1->FR & 0x10) { }  // Wait while the Receive FIFO is empty (check bit 4 in FR register).
-    return (char)(UART1->DR & 0xFF);  // Read the received data (mask with 0xFF to get only the lower 8 bits) and return it.
+    char c;
+    while (!UART1_Read_Character(&c)) { }  // Wait until the ISR has stored a byte in the ring.
+    return c;
 }
 
 // Push Button functions:
@@ -136,6 +375,17 @@ void PushButton_Init(void) {
     GPIOF->DIR &= ~0x10;        // Set PF4 (push button) as input (clear bit 4).
     GPIOF->DEN |= 0x10;         // Enable digital functionality on PF4.
     GPIOF->PUR |= 0x10;         // Enable internal pull-up resistor on PF4.
+    // Interrupt on both edges so a press or release wakes the core from Idle_Sleep at once.
+    GPIOF->IS &= ~0x10;         // Edge-sensitive.
+    GPIOF->IBE |= 0x10;         // Both edges.
+    GPIOF->ICR = 0x10;          // Clear any stale edge.
+    GPIOF->IM |= 0x10;          // Unmask PF4.
+    NVIC_EnableIRQ(GPIOF_IRQn);
+}
+
+void GPIOF_Handler(void) {
+    GPIOF->ICR = 0x10;          // Acknowledge the edge; Button_Job debounces the level on its next run.
+    idle_button_wakes++;
 }
 
 int PushButton_Pressed(void) {
@@ -153,12 +403,12 @@ void RGB_LED_Init(void) {
     GPIOD->DATA &= ~0x03;       // Initialize PD0 and PD1 to low (LEDs off).
 }
 
-void RGB_LED_Set_Normal(float change) {
-    // Change > 0.001: indicate positive change (e.g., green or blue)
-    if (change > 0.001)
+void RGB_LED_Set_Normal(int32_t change_bp) {
+    // Change > 0 (at least +0.01 %): indicate positive change (e.g., green or blue)
+    if (change_bp > 0)
         GPIOD->DATA = (GPIOD->DATA & ~0x03) | 0x02;  // Turn on one LED channel (e.g., PD1)
-    // Change < -0.001: indicate negative change (e.g., red)
-    else if (change < -0.001)
+    // Change < 0 (at least -0.01 %): indicate negative change (e.g., red)
+    else if (change_bp < 0)
         GPIOD->DATA = (GPIOD->DATA & ~0x03) | 0x01;  // Turn on the other LED channel (e.g., PD0)
     else
         GPIOD->DATA &= ~0x03;   // Otherwise, turn all off if change is near zero.
@@ -175,6 +425,13 @@ void RGB_LED_Flash_Yellow(void) {
     }
 }
 
+void RGB_LED_Set_Yellow(int on) {
+    if (on)
+        GPIOD->DATA = (GPIOD->DATA & ~0x03) | 0x03;  // Both channels on: yellow.
+    else
+        GPIOD->DATA &= ~0x03;   // Both channels off.
+}
+
 // Buzzer functions:
 
 void Buzzer_Init(void) {
@@ -196,6 +453,13 @@ void Buzzer_Toggle(void) {
     }
 }
 
+void Buzzer_Set(int on) {
+    if (on)
+        GPIOF->DATA |= 0x02;    // Turn on the buzzer (set PF1).
+    else
+        GPIOF->DATA &= ~0x02;   // Turn off the buzzer (clear PF1).
+}
+
 void Buzzer_Off(void) {
     GPIOF->DATA &= ~0x02;       // Turn off the buzzer by clearing PF1.
 }
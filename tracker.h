@@ -2,25 +2,63 @@
 #ifndef TRACKER_H                 // Prevent multiple inclusions: if TRACKER_H is not defined...
 #define TRACKER_H                 // ...define TRACKER_H to signal this header has been included
 
+#ifdef TRACKER_HOST
+#include "tm4c_host.h"            // Host build: register stand-in so the firmware compiles and runs on Linux
+#define UART1_DR_READ() Host_UART1_Read_DR()  // Host build: pop one entry from the modeled UART1 RX FIFO
+#define LCD_BUS_TRACE(e) Host_LCD_Enable(e)   // Host build: report LCD enable edges to the HD44780 model
+#define UART0_DR_WRITE(b) Host_UART0_Write(b) // Host build: capture bytes sent on UART0 TX
+#define EEPROM_READ_INC() Host_EEPROM_Read_Inc()      // Host build: read the EEPROM model
+#define EEPROM_WRITE_INC(w) Host_EEPROM_Write_Inc(w)  // Host build: program a word in the EEPROM model
+#else
 #include "TM4C123GH6PM.h"         // Include the microcontroller-specific header containing register definitions
+#define UART1_DR_READ() (UART1->DR)  // Reading UART1 DR pops one entry from the hardware RX FIFO
+#define LCD_BUS_TRACE(e)             // No bus tracing on hardware
+#define UART0_DR_WRITE(b) (UART0->DR = (b))  // Writing UART0 DR pushes one byte into the TX FIFO
+#define EEPROM_READ_INC() (EEPROM->EERDWRINC)  // Read the word at EEBLOCK/EEOFFSET and advance EEOFFSET
+#define EEPROM_WRITE_INC(w) (EEPROM->EERDWRINC = (w))  // Program that word and advance EEOFFSET
+#endif
 #include <stdio.h>                // Include the standard I/O library (needed for sprintf, etc.)
 
 #define SystemCoreClock 50000000U  // Define the system core clock as 50,000,000 cycles per second (50 MHz)
 // Explanation: The system clock is set in hardware. Here, 50e6 cycles/second is used for timing functions.
 #define BUFFER_SIZE 128           // Define the size of the UART input buffer as 128 bytes
+#define UART1_RX_RING_SIZE 256    // Size of the interrupt-fed UART1 receive ring (must be a power of two)
 
-// Declaration of global variables used across modules:
-extern float local_threshold;     // 'local_threshold' holds the selected threshold value for price comparison
-extern int alarmStopped;          // 'alarmStopped' is a flag indicating if the alarm has been stopped
+// LCD bus options (both off by default, matching the original 4-wire, write-only hookup):
+// #define LCD_USE_BUSY_FLAG       // R/W wired to PE1: poll the busy flag instead of waiting fixed execution times
+// #define LCD_BUS_8BIT            // D0-D3 wired to PE2-PE5: transfer each byte with a single enable pulse
+
+// UART1 receive statistics (updated by UART1_Handler, read by the main loop):
+extern volatile uint32_t uart1_rx_overruns;    // Bytes dropped because the software ring was full
+extern volatile uint32_t uart1_fifo_overruns;  // Hardware FIFO overruns reported by the OE bit in UART1 DR
+extern volatile uint32_t uart1_rx_errors;      // Bytes discarded because of framing, parity or break errors
 
 // Function prototype declarations:
 
-// Delay routine: creates a blocking delay in milliseconds.
-// 'ms' is the number of milliseconds to delay.
-void DelayMs(uint32_t ms);      
+// Application (main.c): main() is Tracker_Setup() followed by Tracker_Poll() forever.
+void Tracker_Setup(void);         // Initialize the peripherals, alert rules and scheduler jobs
+void Tracker_Poll(void);          // One pass of the main loop (sleeps until the next interrupt when idle)
+
+// SysTick timer service: a free-running 1 ms interrupt drives a monotonic millisecond counter.
+void SysTick_Init(void);          // Start the 1 ms SysTick interrupt (call before any delay or scheduler use)
+void SysTick_Handler(void);       // SysTick interrupt handler: advances the millisecond counter
+uint32_t SysTick_Millis(void);    // Milliseconds since SysTick_Init (wraps after ~49.7 days; compare with subtraction)
+
+// Idle mode: sleep in WFI between events, with clocks gated for peripherals that cannot wake the core.
+extern uint64_t idle_sleep_ticks;      // Clock ticks (50 per us) spent asleep since SysTick_Init
+extern uint32_t idle_wakes;            // Times Idle_Sleep returned
+extern volatile uint32_t idle_button_wakes;  // PF4 edges that raised the GPIOF interrupt
+void Idle_Init(void);             // Configure sleep-mode clock gating (call once at start-up)
+void Idle_Sleep(void);            // Sleep until the next interrupt unless received bytes are already waiting
+uint32_t Idle_Active_Permille(void);  // Share of time awake since SysTick_Init, in 0.1 % steps (duty cycle)
+
+// Delay routines (only for short waits; periodic work belongs in the scheduler, see scheduler.h).
+// 'us' / 'ms' is the number of microseconds / milliseconds to delay.
+void DelayUs(uint32_t us);        // Busy-wait measured against the running SysTick counter
+void DelayMs(uint32_t ms);        // Sleeps between SysTick interrupts until 'ms' milliseconds have passed
 
 // LCD (Liquid Crystal Display) related function prototypes:
-void LCD->Port->Init(void);         // Initialize the GPIO ports used by the LCD
+void LCD_Port_Init(void);         // Initialize the GPIO ports used by the LCD
 void LCD_Pulse_Enable(void);      // Generate an enable pulse to latch data into the LCD
 void LCD_Write_4_Bits(unsigned char nibble);  // Write a 4-bit nibble to the LCD data bus
 void LCD_Send_Command(unsigned char cmd);     // Send a command byte to the LCD
@@ -31,21 +69,26 @@ void LCD_Clear(void);             // Clear the LCD display
 void LCD_Display_String(const char *str);  // Display a null-terminated string on the LCD
 
 // UART (Universal Asynchronous Receiver/Transmitter) function prototypes:
-void UART1_Init(void);            // Initialize UART1 for serial communication
-char UART1_Input_Character(void); // Retrieve a single character from the UART1 receive buffer
+void UART1_Init(void);            // Initialize UART1 for interrupt-driven reception
+void UART1_Handler(void);         // UART1 interrupt handler: drains the hardware RX FIFO into the receive ring
+char UART1_Input_Character(void); // Retrieve a single character from the UART1 receive ring (blocks until one arrives)
+int UART1_Read_Character(char *c);  // Non-blocking read: returns 1 and stores the byte in *c, or 0 if the ring is empty
 
 // Push Button function prototypes:
 void PushButton_Init(void);       // Initialize the push button (set direction, enable pull-up resistor)
 int PushButton_Pressed(void);     // Check and return whether the push button is currently pressed
+void GPIOF_Handler(void);         // PF4 edge interrupt: only wakes the core (counted in idle_button_wakes)
 
 // RGB LED (Red, Green, Blue Light Emitting Diode) function prototypes:
 void RGB_LED_Init(void);          // Initialize the GPIO ports for the RGB LED
-void RGB_LED_Set_Normal(float change);  // Set the LED color based on a given change value
+void RGB_LED_Set_Normal(int32_t change_bp);  // Set the LED color based on a change in basis points (0.01 %)
 void RGB_LED_Flash_Yellow(void);  // Flash the RGB LED yellow (used as an alert indication)
+void RGB_LED_Set_Yellow(int on);  // Turn the RGB LED yellow (on != 0) or off, for patterned alert output
 
 // Buzzer function prototypes:
 void Buzzer_Init(void);           // Initialize the GPIO port for the buzzer
 void Buzzer_Toggle(void);         // Toggle the buzzer on and off
+void Buzzer_Set(int on);          // Turn the buzzer on (on != 0) or off
 void Buzzer_Off(void);            // Turn the buzzer off
 
 #endif // TRACKER_H            // End of inclusion guard for tracker.h
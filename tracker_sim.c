@@ -0,0 +1,831 @@
+//tracker_sim.c
+// Linux simulator for the TM4C firmware: runs main.c unchanged against the peripheral models in
+// tm4c_host.c (virtual-time SysTick, UART1 wire and RX FIFO, HD44780, EEPROM) and drives it from a script
+// or from the built-in benchmark suite. Build:
+//   cc -O2 -DTRACKER_HOST -o tracker_sim tracker_sim.c main.c tracker.c tm4c_host.c scheduler.c
+//      lcd_buffer.c price_format.c link_protocol.c asset_table.c alert.c history.c profile.c config_store.c
+//      tick_log.c
+// (add -DTRACKER_PROFILE to enable the probes; send "line PROFILE" to request a dump, see profile.h)
+// Usage:
+//   tracker_sim [-b baud] [-p poll_us] [-t] [-o file] [-e file] script|-
+//                         Run a script ('-' = stdin); -t traces LED/buzzer/button, -o saves the UART0 output,
+//                         -e loads the EEPROM image from file (if it exists) and saves it back afterwards
+//   tracker_sim -B [-b baud] [-p poll_us]              Benchmark: byte-to-pixel latency and LCD bytes per frame;
+//                                                      fails if a message is lost
+//   tracker_sim -L                                     LCD benchmark: characters per second of the original
+//                                                      driver and this build's driver on the HD44780 model
+//                                                      (build with -DLCD_USE_BUSY_FLAG / -DLCD_BUS_8BIT too)
+//   tracker_sim -I [-p poll_us]                        Idle check: one simulated hour of 20-60 s price lines;
+//                                                      fails unless the core sleeps > 99 % of the time
+//   tracker_sim -W [-p poll_us]                        Boot benchmark: power-up to first price on the panel,
+//                                                      cold (empty EEPROM) and warm (saved settings and cache)
+//   tracker_sim -R capture.tkl|synth[:batches] [-x speed] [-M pct] [-U n] [-T] [-S] [-w out.tkl] [-b baud] [-p us]
+//                         Replay a tick capture (see tick_log.h) or a synthetic random walk (all assets every
+//                         20 s, 180 batches by default) into UART1. -x: 1 = real time (default), 100 = 100x,
+//                         0 = line rate; -M: inject a malformed message before pct % of the ticks; -U: send
+//                         every 10th tick as a burst of n; -T: BTC text lines instead of frames (and only text
+//                         garbage); -S: also search for the highest loss-free message rate; -w: save the series
+//                         as a capture
+//
+// Checks (each run exits non-zero on a failure):
+//   tracker_sim -B                             no message lost or byte overrun in any scenario
+//   tracker_sim -I                             asleep > 99 % of an hour, every line parsed, every press woke it
+//   tracker_sim -R synth -x 0 -M 20 -U 5       frames at line rate with malformed input and bursts: none lost
+//   tracker_sim -R synth:60 -x 0 -T -M 10      text lines at line rate with text garbage in between: none lost
+//
+// Script lines ('#' starts a comment; times are milliseconds since power-up, in order):
+//   <ms> line <text>                  send "<text>\n"
+//   <ms> price <ticker> <usd> [<pct>] send a binary price frame (e.g. "9000 price ETH 3120.55 -1.2")
+//   <ms> button down|up               press or release the PF4 button
+//   <ms> screen                       print both LCD rows
+//   <ms> end                          stop (otherwise the run ends 1 s after the last line)
+
+#include "tracker.h"
+#include "lcd_buffer.h"
+#include "price_format.h"
+#include "link_protocol.h"
+#include "asset_table.h"
+#include "history.h"
+#include "config_store.h"
+#include "tick_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#define SIM_RUN_MS       8000     // Benchmarks start once the picker and "Threshold Saved" screens are gone
+#define SIM_MAX_MESSAGES 4096     // Price messages tracked per benchmark scenario
+#define SIM_FIRST_PRICE_MS 6000   // Boot benchmark: the ESP32 has joined WiFi and sends its first price
+#define SIM_BOOT_RUN_MS  30000    // Boot benchmark: length of each power-up
+
+static uint32_t poll_us = 5;      // Modeled CPU time of one main loop pass that does no waiting
+static int trace = 0;             // 1 to print GPIO changes
+static FILE *uart0_out = 0;       // Where UART0 output goes (-o), or 0 to discard it
+
+// Runs the firmware until virtual time 'end_us', one main loop pass at a time.
+static void (*on_poll)(void) = 0; // Called after every pass (screen checks, traces)
+
+static void Run_Until(uint64_t end_us) {
+    uint8_t tx[256];
+    while (Host_Time_Us() < end_us) {
+        Tracker_Poll();
+        Host_Advance_Us(poll_us);
+        if (on_poll)
+            on_poll();
+        uint32_t n = Host_UART0_Take(tx, sizeof(tx));
+        if (n && uart0_out)
+            fwrite(tx, 1, n, uart0_out);
+    }
+}
+
+static void Print_Screen(void) {
+    // Custom characters 0x08-0x0F are the sparkline bars; print them as block elements.
+    static const char *const bars[8] = { "▁", "▂", "▃", "▄",
+                                         "▅", "▆", "▇", "█" };
+    char row[LCD_COLS + 1];
+    for (int r = 0; r < LCD_ROWS; r++) {
+        Host_LCD_Row(r, row);
+        printf("%10.3f |", Host_Time_Us() / 1000.0);
+        for (int i = 0; i < LCD_COLS; i++) {
+            unsigned char c = (unsigned char)row[i];
+            if (c >= HISTORY_GLYPH_CODE && c < HISTORY_GLYPH_CODE + 8)
+                fputs(bars[c - HISTORY_GLYPH_CODE], stdout);
+            else
+                putchar(c >= 0x20 && c < 0x7F ? c : '?');
+        }
+        printf("|\n");
+    }
+}
+
+static void Trace_Poll(void) {
+    static uint32_t last = 0xFFFFFFFF;
+    uint32_t state = (GPIOD->DATA & 0x03) | (GPIOF->DATA & 0x12) << 4;
+    if (state == last)
+        return;
+    last = state;
+    printf("%10.3f  led=%c%c buzzer=%d button=%s\n", Host_Time_Us() / 1000.0,
+           (state & 0x01) ? 'R' : '-', (state & 0x02) ? 'G' : '-', (state >> 5) & 1,
+           (state & 0x100) ? "up" : "down");
+}
+
+static void Send_Line(const char *text) {
+    Host_UART1_Send((const uint8_t *)text, (uint32_t)strlen(text));
+    Host_UART1_Send((const uint8_t *)"\n", 1);
+}
+
+static void Send_Frame(int asset, int32_t cents, int32_t change_bp) {
+    static uint8_t seq = 0;
+    uint8_t frame[LINK_PRICE_FRAME];
+    Link_Price price = { (uint8_t)asset, cents, (int16_t)change_bp, 0 };
+    Link_Encode_Price(frame, seq++, &price);
+    Host_UART1_Send(frame, sizeof(frame));
+}
+
+static int Ticker_Id(const char *name) {
+    for (int id = 0; id < ASSET_MAX; id++)
+        if (asset_ticker[id] && strcmp(asset_ticker[id], name) == 0)
+            return id;
+    return atoi(name);            // Numeric asset ids are accepted too.
+}
+
+static int Run_Script(FILE *in) {
+    char line[256];
+    uint64_t end_us = 0;
+    int lineno = 0;
+    if (trace)
+        on_poll = Trace_Poll;
+    while (fgets(line, sizeof(line), in)) {
+        char cmd[16], arg[200];
+        unsigned long ms;
+        int n = 0;
+        lineno++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        if (sscanf(line, "%lu %15s %n", &ms, cmd, &n) < 2)
+            continue;             // Blank or comment line.
+        strcpy(arg, line + n);
+        Run_Until((uint64_t)ms * 1000);
+        if (strcmp(cmd, "line") == 0) {
+            Send_Line(arg);
+        } else if (strcmp(cmd, "price") == 0) {
+            char ticker[16], usd[24], pct[24] = "0";
+            int32_t cents, change = 0;
+            if (sscanf(arg, "%15s %23s %23s", ticker, usd, pct) < 2 || !Price_Parse_Fixed2(usd, &cents) ||
+                !Price_Parse_Fixed2(pct, &change)) {
+                fprintf(stderr, "line %d: bad price\n", lineno);
+                return 1;
+            }
+            Send_Frame(Ticker_Id(ticker), cents, change);
+        } else if (strcmp(cmd, "button") == 0) {
+            Host_Button(strcmp(arg, "down") == 0);
+        } else if (strcmp(cmd, "screen") == 0) {
+            Print_Screen();
+        } else if (strcmp(cmd, "end") == 0) {
+            return 0;
+        } else {
+            fprintf(stderr, "line %d: unknown command '%s'\n", lineno, cmd);
+            return 1;
+        }
+        end_us = (uint64_t)ms * 1000 + 1000000;
+    }
+    Run_Until(end_us);
+    Print_Screen();
+    return 0;
+}
+
+// Benchmark bookkeeping: every price message gets a unique BTC price, so the screen says which one it shows.
+static char expected[SIM_MAX_MESSAGES][LCD_COLS + 1];  // Row 1 once message k is displayed
+static uint64_t arrived_us[SIM_MAX_MESSAGES];          // When the last byte of message k reached the pins
+static uint32_t latency_us[SIM_MAX_MESSAGES];
+static int sent = 0, shown = 0, superseded = 0, oldest_pending = 0;
+
+static void Bench_Poll(void) {
+    static char last[LCD_COLS + 1];
+    char row[LCD_COLS + 1];
+    Host_LCD_Row(1, row);
+    if (strcmp(row, last) == 0)
+        return;
+    strcpy(last, row);
+    uint64_t now = Host_Time_Us();
+    for (int k = sent - 1; k >= oldest_pending; k--) {
+        if (arrived_us[k] <= now && strcmp(expected[k], row) == 0) {
+            latency_us[shown++] = (uint32_t)(now - arrived_us[k]);
+            superseded += k - oldest_pending;  // Older messages were overtaken before they reached the panel.
+            oldest_pending = k + 1;
+            break;
+        }
+    }
+}
+
+static void Bench_Send(int binary) {
+    int32_t cents = 6000000 + sent * 100;  // $60,000 + k: increasing, so no alert takes over the screen.
+    char text[64];
+    Price_Format_Line(text, sizeof(text), cents, 123);
+    snprintf(expected[sent], sizeof(expected[sent]), "%-16.16s", text);
+    if (binary) {
+        Send_Frame(LINK_ASSET_BTC, cents, 123);
+    } else {
+        snprintf(text, sizeof(text), "BTC Price: $%ld.%02ld, 24h Change: 1.23%%", (long)(cents / 100),
+                 (long)(cents % 100));
+        Send_Line(text);
+    }
+    arrived_us[sent++] = Host_UART1_Wire_Done_Us();
+}
+
+static int Compare_U32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Sends 'bursts' bursts of 'per_burst' messages, 'gap_ms' apart, and reports latency and losses. Returns 1 if
+// a message was dropped or a byte overran the FIFO or the ring.
+static int Bench_Scenario(const char *name, int binary, int bursts, int per_burst, uint32_t gap_ms) {
+    on_poll = Bench_Poll;
+    uint64_t t = (uint64_t)SIM_RUN_MS * 1000;
+    for (int b = 0; b < bursts; b++, t += (uint64_t)gap_ms * 1000) {
+        Run_Until(t);
+        for (int i = 0; i < per_burst && sent < SIM_MAX_MESSAGES; i++)
+            Bench_Send(binary);
+    }
+    Run_Until(Host_UART1_Wire_Done_Us() + 500000);  // Let the last message reach the panel.
+    int parsed = (uint16_t)history[LINK_ASSET_BTC].seq;
+    qsort(latency_us, (size_t)shown, sizeof(latency_us[0]), Compare_U32);
+    printf("%-24s %5d %5d %5d %5d %5lu", name, sent, parsed, sent - parsed, superseded,
+           (unsigned long)(uart1_rx_overruns + uart1_fifo_overruns));
+    if (shown)
+        printf(" %7.2f %7.2f %7.2f %7.2f", latency_us[shown / 2] / 1000.0, latency_us[shown * 9 / 10] / 1000.0,
+               latency_us[shown * 99 / 100] / 1000.0, latency_us[shown - 1] / 1000.0);
+    else
+        printf("       -       -       -       -");
+    // Panel traffic: frames committed with changes, average bytes per frame (data and cursor commands), truncated
+    // commits.
+    printf(" %6lu %5.1f %4lu\n", (unsigned long)lcd_frames, lcd_frames ? (double)lcd_bytes_total / lcd_frames : 0.0,
+           (unsigned long)lcd_queue_overflows);
+    return parsed != sent || uart1_rx_overruns + uart1_fifo_overruns != 0;
+}
+
+// Each scenario runs in its own process so it starts from a freshly reset firmware. Returns 1 if it lost data.
+static int Bench_Fork(const char *name, int binary, int bursts, int per_burst, uint32_t gap_ms) {
+    int status = 1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        Tracker_Setup();
+        int lost = Bench_Scenario(name, binary, bursts, per_burst, gap_ms);
+        fflush(stdout);
+        _exit(lost);
+    }
+    waitpid(pid, &status, 0);
+    return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+// Fails if any scenario drops a message or overruns: the bursts and back-to-back runs are the zero-loss check
+// for the receive ring.
+static int Run_Bench(uint32_t baud) {
+    int failed = 0;
+    printf("baud %lu, %lu us per idle main loop pass; latency = last byte in -> row 1 updated (ms)\n",
+           (unsigned long)baud, (unsigned long)poll_us);
+    printf("%-24s %5s %5s %5s %5s %5s %7s %7s %7s %7s %6s %5s %4s\n", "scenario", "sent", "parsd", "drop", "supsd",
+           "ovrun", "p50", "p90", "p99", "max", "lcdfr", "B/fr", "qovf");
+    failed |= Bench_Fork("text, 1 line/s", 0, 60, 1, 1000);
+    failed |= Bench_Fork("text, 10 lines/s", 0, 200, 1, 100);
+    failed |= Bench_Fork("text, bursts of 20", 0, 20, 20, 1000);
+    failed |= Bench_Fork("text, 1000 back-to-back", 0, 1, 1000, 0);
+    failed |= Bench_Fork("frame, 10 frames/s", 1, 200, 1, 100);
+    failed |= Bench_Fork("frame, bursts of 50", 1, 20, 50, 1000);
+    failed |= Bench_Fork("frame, 3000 back-to-back", 1, 1, 3000, 0);
+    if (failed)
+        printf("FAIL: messages dropped or bytes overrun\n");
+    return failed;
+}
+
+// LCD benchmark (-L): the original driver's bus sequence, replayed against the same HD44780 model. It held
+// E high for 1 ms and low for 1 ms per nibble and waited 2 ms after every byte; its DelayMs reprogrammed
+// SysTick, so those waits were exact.
+static void Legacy_Write_4_Bits(unsigned char nibble) {
+    GPIOA->DATA = (GPIOA->DATA & ~0x3CU) | ((nibble & 0x0FU) << 2);
+    GPIOC->DATA |= 0x40;
+    Host_LCD_Enable(1);
+    Host_Advance_Us(1000);
+    GPIOC->DATA &= ~0x40U;
+    Host_LCD_Enable(0);
+    Host_Advance_Us(1000);
+}
+
+static void Legacy_Send(int rs, unsigned char value) {
+    GPIOE->DATA = rs ? (GPIOE->DATA | 0x01) : (GPIOE->DATA & ~0x01U);
+    Legacy_Write_4_Bits(value >> 4);
+    Legacy_Write_4_Bits(value & 0x0F);
+    Host_Advance_Us(2000);
+}
+
+// Writes 'screens' full screens (a cursor command and 16 characters per row) with either driver and
+// reports the character rate, the model's timing violations and whether the panel shows the last screen.
+static void LCD_Bench_Run(const char *name, int legacy, int screens) {
+    char text[LCD_ROWS][LCD_COLS + 1], row[LCD_COLS + 1];
+    uint32_t violations = host_lcd_violations, chars = 0, commands = 0;
+    uint64_t start = Host_Time_Us();
+    int shown = 1;
+    for (int s = 0; s < screens; s++) {
+        snprintf(text[0], sizeof(text[0]), "BTC %5d  %5d", s, screens - s);
+        snprintf(text[1], sizeof(text[1]), "$%-7d +%d.%02d%%", 60000 + s, s % 10, s % 100);
+        for (int r = 0; r < LCD_ROWS; r++) {
+            if (legacy)
+                Legacy_Send(0, (unsigned char)(0x80 | (r ? 0x40 : 0x00)));
+            else
+                LCD_Set_Cursor(0, (unsigned char)r);
+            commands++;
+            for (int i = 0; i < LCD_COLS; i++, chars++) {
+                unsigned char c = text[r][i] ? (unsigned char)text[r][i] : ' ';
+                if (legacy)
+                    Legacy_Send(1, c);
+                else
+                    LCD_Send_Data(c);
+            }
+        }
+    }
+    uint64_t us = Host_Time_Us() - start;
+    for (int r = 0; r < LCD_ROWS; r++) {
+        Host_LCD_Row(r, row);
+        shown &= strncmp(row, text[r], strlen(text[r])) == 0;
+    }
+    printf("%-34s %6lu %6lu %9.1f %9.0f %8.1f %6lu  %s\n", name, (unsigned long)chars, (unsigned long)commands,
+           us / 1000.0, us ? chars * 1e6 / us : 0.0, (double)us / chars,
+           (unsigned long)(host_lcd_violations - violations), shown ? "ok" : "WRONG");
+}
+
+static int Run_LCD_Bench(void) {
+    const int screens = 100;
+    SysTick_Init();
+    LCD_Init();
+    printf("HD44780 model: %d screens, each 2 rows of a cursor command and 16 characters\n", screens);
+    printf("%-34s %6s %6s %9s %9s %8s %6s  %s\n", "driver", "chars", "cmds", "time ms", "chars/s", "us/char",
+           "viol", "screen");
+#ifdef LCD_BUS_8BIT
+    printf("%-34s (4-bit only: skipped in an LCD_BUS_8BIT build)\n", "original (1 ms E, 2 ms per byte)");
+#else
+    LCD_Bench_Run("original (1 ms E, 2 ms per byte)", 1, screens);
+#endif
+#if defined(LCD_USE_BUSY_FLAG) && defined(LCD_BUS_8BIT)
+    LCD_Bench_Run("datasheet (busy flag, 8-bit)", 0, screens);
+#elif defined(LCD_USE_BUSY_FLAG)
+    LCD_Bench_Run("datasheet (busy flag, 4-bit)", 0, screens);
+#elif defined(LCD_BUS_8BIT)
+    LCD_Bench_Run("datasheet (fixed waits, 8-bit)", 0, screens);
+#else
+    LCD_Bench_Run("datasheet (fixed waits, 4-bit)", 0, screens);
+#endif
+    return host_lcd_violations != 0;
+}
+
+// Boot benchmark: when row 0 first shows an asset (cached or live) and when it first shows a live price.
+static uint64_t first_frame_us = 0, first_live_us = 0;
+static uint32_t boot_image[HOST_EEPROM_WORDS];  // EEPROM contents left by the previous power-up
+
+static void Boot_Poll(void) {
+    char top[LCD_COLS + 1];
+    if (LCD_Flush_Pending())
+        return;                   // Only count complete frames.
+    Host_LCD_Row(0, top);
+    if (strncmp(top, "BTC", 3) != 0)
+        return;
+    if (!first_frame_us)
+        first_frame_us = Host_Time_Us();
+    if (!first_live_us && !strstr(top, "(stale)"))
+        first_live_us = Host_Time_Us();
+}
+
+// Powers up with 'boot_image' in the EEPROM (the button held for the first second if 'hold'); the ESP32
+// sends a BTC price every 10 s from SIM_FIRST_PRICE_MS. Reports the time to the first frames, then passes
+// the EEPROM contents back through 'image_out' (if >= 0) for the next power-up.
+static void Boot_Fork(const char *name, int hold, int32_t cents, int image_out) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        char text[64];
+        memcpy(host_eeprom, boot_image, sizeof(host_eeprom));
+        on_poll = Boot_Poll;
+        Host_Button(hold);
+        Tracker_Setup();
+        Run_Until(1000000);
+        Host_Button(0);
+        for (uint64_t t = (uint64_t)SIM_FIRST_PRICE_MS * 1000; t < (uint64_t)SIM_BOOT_RUN_MS * 1000; t += 10000000) {
+            Run_Until(t);
+            snprintf(text, sizeof(text), "BTC Price: $%ld.%02ld, 24h Change: 1.00%%", (long)(cents / 100),
+                     (long)(cents % 100));
+            Send_Line(text);
+        }
+        Run_Until((uint64_t)SIM_BOOT_RUN_MS * 1000);
+        uint32_t wear = 0;
+        for (int i = 0; i < HOST_EEPROM_WORDS; i++)
+            if (host_eeprom_writes[i] > wear)
+                wear = host_eeprom_writes[i];
+        printf("%-30s %9.1f %9.1f %7lu %7lu %5lu\n", name, first_frame_us / 1000.0, first_live_us / 1000.0,
+               (unsigned long)store_writes, (unsigned long)wear, (unsigned long)(store_errors + host_eeprom_violations));
+        fflush(stdout);
+        if (image_out >= 0 && write(image_out, host_eeprom, sizeof(host_eeprom)) != (ssize_t)sizeof(host_eeprom))
+            _exit(1);
+        _exit(0);
+    }
+    waitpid(pid, 0, 0);
+}
+
+static int Run_Boot_Bench(void) {
+    int image[2];
+    if (pipe(image) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    memset(boot_image, 0xFF, sizeof(boot_image));  // Erased EEPROM.
+    printf("first price from the ESP32 at %d ms; times from power-up (ms)\n", SIM_FIRST_PRICE_MS);
+    printf("%-30s %9s %9s %7s %7s %5s\n", "power-up", "1st frame", "1st live", "written", "wear", "errs");
+    Boot_Fork("cold: empty EEPROM", 0, 6012345, image[1]);
+    if (read(image[0], boot_image, sizeof(boot_image)) != (ssize_t)sizeof(boot_image)) {
+        fprintf(stderr, "no EEPROM image from the first power-up\n");
+        return 1;
+    }
+    Boot_Fork("warm: saved settings + cache", 0, 6100000, -1);
+    Boot_Fork("warm, button held: picker", 1, 6100000, -1);
+    return 0;
+}
+
+// Replay (-R): the series to send, its options and the counters of the current run.
+typedef struct {
+    uint32_t ms;                  // Offset from the first tick of the series
+    Link_Price price;
+} Replay_Tick;
+
+static Replay_Tick *series = 0;
+static int series_count = 0;
+static double replay_speed = 1;   // -x
+static int malformed_pct = 0;     // -M
+static int burst_size = 0;        // -U
+static int text_lines = 0;        // -T
+static int valid_sent = 0, malformed_sent = 0;
+
+static void Series_Add(uint32_t ms, const Link_Price *price) {
+    static int capacity = 0;
+    if (series_count == capacity) {
+        capacity = capacity ? capacity * 2 : 1024;
+        series = realloc(series, (size_t)capacity * sizeof(series[0]));
+        if (!series) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    series[series_count].ms = ms;
+    series[series_count++].price = *price;
+}
+
+// Loads a capture; segments are laid end to end, one second apart. Returns 0 on error.
+static int Series_Load(const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return 0;
+    }
+    static uint8_t buf[1 << 22];
+    uint32_t size = (uint32_t)fread(buf, 1, sizeof(buf), in), at = Tick_Log_Check_Header(buf, (uint32_t)size);
+    fclose(in);
+    if (!at) {
+        fprintf(stderr, "%s: not a tick capture\n", path);
+        return 0;
+    }
+    Tick_Log log = { 0 };
+    uint32_t ms, segment = 0, base = 0, last = 0;
+    Link_Price price;
+    int n;
+    while ((n = Tick_Log_Decode(&log, buf + at, size - at, &ms, &price)) > 0) {
+        at += (uint32_t)n;
+        if (log.segments != segment) {
+            base = series_count ? last + 1000 : 0;  // Next power-up: continue the timeline.
+            segment = log.segments;
+        }
+        last = base + ms;
+        Series_Add(last, &price);
+    }
+    if (n < 0)
+        fprintf(stderr, "%s: malformed record at byte %lu, replaying the %d ticks before it\n", path,
+                (unsigned long)at, series_count);
+    return series_count > 0;
+}
+
+// Synthetic series: every asset in one batch every 20 s (like Bitcoin_tracker.ino), each on a random walk
+// with steps of up to 0.2 %.
+static void Series_Synthetic(int batches) {
+    static const int32_t start_cents[] = { 6000000, 300000, 15000, 60, 45, 15, 8000, 700, 1500, 12 };
+    int32_t cents[LINK_ASSET_COUNT];
+    Link_Price price = { 0 };
+    srand(7);
+    for (int a = 0; a < LINK_ASSET_COUNT; a++)
+        cents[a] = start_cents[a % (int)(sizeof(start_cents) / sizeof(start_cents[0]))];
+    for (int b = 0; b < batches; b++) {
+        for (int a = 0; a < LINK_ASSET_COUNT; a++) {
+            cents[a] += (int32_t)((int64_t)cents[a] * (rand() % 41 - 20) / 10000);
+            if (cents[a] < 1)
+                cents[a] = 1;         // Never zero: the cheapest assets start at a few cents.
+            price.asset_id = (uint8_t)a;
+            price.price_cents = cents[a];
+            price.change_bp = (int16_t)(rand() % 2001 - 1000);
+            price.timestamp = 1700000000U + (uint32_t)b * 20;
+            Series_Add((uint32_t)b * 20000, &price);
+        }
+    }
+}
+
+static int Series_Save(const char *path) {
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        return 0;
+    }
+    Tick_Log log = { 0 };
+    uint8_t buf[TICK_LOG_MAX_RECORD + TICK_LOG_HEADER_SIZE + TICK_LOG_SEGMENT_SIZE];
+    uint32_t start = series_count ? series[0].price.timestamp : 0;
+    long bytes = fwrite(buf, 1, (size_t)Tick_Log_Start(&log, buf, start, 1), out);
+    for (int i = 0; i < series_count; i++)
+        bytes += (long)fwrite(buf, 1, (size_t)Tick_Log_Encode(&log, buf, series[i].ms, &series[i].price), out);
+    fclose(out);
+    printf("saved %d ticks to %s: %ld bytes (%.1f per tick, %d as frames)\n", series_count, path, bytes,
+           series_count ? (double)bytes / series_count : 0.0, series_count * LINK_PRICE_FRAME);
+    return 1;
+}
+
+// Sends one price as a frame, or as a BTC text line with -T (other assets are skipped then).
+static void Replay_Send(const Link_Price *p) {
+    char text[64];
+    if (!text_lines) {
+        Send_Frame(p->asset_id, p->price_cents, p->change_bp);
+    } else if (p->asset_id == LINK_ASSET_BTC) {
+        snprintf(text, sizeof(text), "BTC Price: $%ld.%02ld, 24h Change: %.2f%%", (long)(p->price_cents / 100),
+                 (long)(p->price_cents % 100), p->change_bp / 100.0);
+        Send_Line(text);
+    } else {
+        return;
+    }
+    valid_sent++;
+}
+
+// Sends one malformed message, rotating through the kinds the link has to survive.
+static void Replay_Malformed(void) {
+    uint8_t frame[LINK_PRICE_FRAME];
+    Link_Price p = { LINK_ASSET_BTC, 6000000, 0, 0 };
+    // A text-only sender (-T) never sends LINK_SYNC, so its garbage is text: broken lines and noise without
+    // sync bytes. Frame garbage in front of a text line would take the start of the line with it.
+    int kind = text_lines ? (malformed_sent % 2) * 3 : malformed_sent % 4;
+    malformed_sent++;
+    switch (kind) {
+    case 0:                       // Text line with a broken number.
+        Send_Line("BTC Price: $6O,0x1.5, 24h Change: --2%");
+        break;
+    case 1:                       // Frame with a bit flipped in the payload: fails the CRC.
+        Link_Encode_Price(frame, 0, &p);
+        frame[6] ^= 0x10;
+        Host_UART1_Send(frame, sizeof(frame));
+        break;
+    case 2:                       // Frame cut off after 9 bytes (the next message completes its length).
+        Link_Encode_Price(frame, 0, &p);
+        Host_UART1_Send(frame, 9);
+        break;
+    default:                      // Line noise: random bytes, sync bytes included unless -T, then a line end.
+        for (int i = 0; i < 24; i++) {
+            uint8_t noise = (uint8_t)rand();
+            if (text_lines && (noise == LINK_SYNC || noise == '\n'))
+                noise = '?';
+            frame[i % sizeof(frame)] = (uint8_t)(i % 7 == 3 && !text_lines ? LINK_SYNC : noise);
+        }
+        Host_UART1_Send(frame, sizeof(frame));
+        Host_UART1_Send((const uint8_t *)"\n", 1);
+        break;
+    }
+}
+
+// Ticks displayed or rejected by the firmware so far: every stored price goes through History_Add.
+static int Replay_Parsed(void) {
+    int parsed = 0;
+    for (int a = 0; a < ASSET_MAX; a++)
+        parsed += (uint16_t)history[a].seq;
+    return parsed;
+}
+
+// Streams the first 'count' ticks: 'gap_us' apart if non-zero, otherwise at the replay speed (line rate
+// when 0). Returns the virtual time from the first byte until the firmware had taken the last message.
+static uint64_t Replay_Run(int count, uint32_t gap_us) {
+    uint64_t start = Host_Time_Us(), done = start;
+    for (int i = 0; i < count; i++) {
+        uint64_t due = Host_Time_Us();
+        if (gap_us)
+            due = start + (uint64_t)i * gap_us;
+        else if (replay_speed > 0)
+            due = start + (uint64_t)((series[i].ms - series[0].ms) * 1000.0 / replay_speed);
+        Run_Until(due);
+        // Keep no more than 20 ms queued on the wire, so long series at line rate fit the wire model.
+        if (Host_UART1_Wire_Done_Us() > Host_Time_Us() + 20000)
+            Run_Until(Host_UART1_Wire_Done_Us() - 10000);
+        if (malformed_pct && rand() % 100 < malformed_pct)
+            Replay_Malformed();
+        Replay_Send(&series[i].price);
+        for (int k = 1; burst_size && i % 10 == 9 && k < burst_size; k++) {
+            Link_Price p = series[i].price;
+            p.price_cents += k;   // Distinct prices, so every one of them is a real update.
+            Replay_Send(&p);
+        }
+    }
+    // Wait for the wire to drain and the firmware to take every message (or give up 1 s later).
+    uint64_t deadline = Host_UART1_Wire_Done_Us() + 1000000;
+    while (Host_Time_Us() < deadline && Replay_Parsed() < valid_sent)
+        Run_Until(Host_Time_Us() + 1000);
+    done = Host_Time_Us();
+    return done - start;
+}
+
+static int Replay_Lost(void) {
+    return valid_sent - Replay_Parsed() + (int)(uart1_rx_overruns + uart1_fifo_overruns);
+}
+
+// One rate-search trial in a fresh firmware: 1 if 'count' ticks 'gap_us' apart all got through. Malformed
+// messages are left out: what they destroy does not depend on the rate.
+static int Replay_Trial(int count, uint32_t gap_us) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        malformed_pct = 0;
+        Tracker_Setup();
+        Run_Until((uint64_t)SIM_RUN_MS * 1000);
+        Replay_Run(count, gap_us);
+        _exit(Replay_Lost() == 0 ? 0 : 1);
+    }
+    int status = 1;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Binary search on the message spacing, from the wire's own limit up to 100 ms, for the highest rate the
+// firmware takes without losing a message.
+static void Replay_Search(uint32_t baud) {
+    int count = series_count < 2000 ? series_count : 2000;
+    uint32_t bytes = text_lines ? 44 : LINK_PRICE_FRAME;
+    uint32_t low = (uint32_t)(10000000ULL * bytes / baud), high = 100000;
+    if (Replay_Trial(count, low)) {
+        printf("max loss-free rate: line rate (%.0f messages/s, %lu us apart)\n", 1e6 / low, (unsigned long)low);
+    } else if (!Replay_Trial(count, high)) {
+        printf("max loss-free rate: none (messages lost even %lu ms apart)\n", (unsigned long)(high / 1000));
+    } else {
+        while (high - low > 1 + high / 100) {   // Stop within 1 %.
+            uint32_t mid = (low + high) / 2;
+            if (Replay_Trial(count, mid))
+                high = mid;
+            else
+                low = mid;
+        }
+        printf("max loss-free rate: %.0f messages/s (%lu us apart; line rate %.0f/s)\n", 1e6 / high,
+               (unsigned long)high, baud / 10.0 / bytes);
+    }
+}
+
+static int Run_Replay(const char *source, const char *save, int search, uint32_t baud) {
+    if (strncmp(source, "synth", 5) == 0)
+        Series_Synthetic(source[5] == ':' ? atoi(source + 6) : 180);
+    else if (!Series_Load(source))
+        return 1;
+    if (series_count == 0) {
+        fprintf(stderr, "empty series\n");
+        return 1;
+    }
+    if (save && !Series_Save(save))
+        return 1;
+    // The replay runs in its own process, so the rate-search trials below also start from a fresh firmware.
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) {
+        int status = 1;
+        waitpid(pid, &status, 0);
+        if (search)
+            Replay_Search(baud);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+    }
+    Tracker_Setup();
+    Run_Until((uint64_t)SIM_RUN_MS * 1000);
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64_t run_us = Replay_Run(series_count, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double host_s = (double)(t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    int parsed = Replay_Parsed();
+    char speed[24] = "line rate";
+    if (replay_speed > 0)
+        snprintf(speed, sizeof(speed), "%gx real time", replay_speed);
+    printf("replayed %d ticks from %s at %s, %lu baud: %d messages sent, %d malformed injected\n", series_count,
+           source, speed, (unsigned long)baud, valid_sent, malformed_sent);
+    printf("processed %d/%d (%d lost, %lu overruns, %lu rx errors) in %.3f s virtual: %.1f messages/s\n", parsed,
+           valid_sent, valid_sent - parsed, (unsigned long)(uart1_rx_overruns + uart1_fifo_overruns),
+           (unsigned long)uart1_rx_errors, run_us / 1e6, run_us ? parsed * 1e6 / run_us : 0.0);
+    printf("host: %.3f s, %.0fx faster than real time\n", host_s, host_s > 0 ? run_us / 1e6 / host_s : 0.0);
+    fflush(stdout);
+    _exit(valid_sent == parsed ? 0 : 1);
+}
+
+// One simulated hour with a price line every 20-60 s (like the ESP32 sketch) and a few button presses.
+// Returns 0 if the duty cycle and wake counts are as expected.
+static int Run_Idle_Check(void) {
+    const uint32_t hour_ms = 3600000;
+    int lines = 0, presses = 0, failed = 0;
+    uint64_t t = (uint64_t)SIM_RUN_MS * 1000;
+    char text[64];
+    Tracker_Setup();
+    srand(1);
+    while (t < (uint64_t)hour_ms * 1000) {
+        Run_Until(t);
+        snprintf(text, sizeof(text), "BTC Price: $%d.00, 24h Change: 0.50%%", 60000 + rand() % 1000);
+        Send_Line(text);
+        lines++;
+        if (lines % 25 == 0) {    // Flip the page now and then: press and release 200 ms later.
+            Host_Button(1);
+            Run_Until(Host_Time_Us() + 200000);
+            Host_Button(0);
+            presses++;
+        }
+        t += (20000 + (uint64_t)(rand() % 40001)) * 1000;
+    }
+    Run_Until((uint64_t)hour_ms * 1000);
+    uint32_t ms = SysTick_Millis();
+    uint32_t active = Idle_Active_Permille();
+    int parsed = (uint16_t)history[LINK_ASSET_BTC].seq;
+    printf("simulated %.1f min: active %u.%u %%, %lu wakes (%.3f per ms), %lu button wakes, %d/%d lines parsed\n",
+           ms / 60000.0, active / 10, active % 10, (unsigned long)idle_wakes, (double)idle_wakes / ms,
+           (unsigned long)idle_button_wakes, parsed, lines);
+    if (active >= 10) {
+        printf("FAIL: awake %u.%u %% of the time (limit 1 %%)\n", active / 10, active % 10);
+        failed = 1;
+    }
+    if (idle_button_wakes != 2U * presses) {
+        printf("FAIL: %lu button wakes for %d presses\n", (unsigned long)idle_button_wakes, presses);
+        failed = 1;
+    }
+    if (parsed != lines) {
+        printf("FAIL: %d of %d lines parsed\n", parsed, lines);
+        failed = 1;
+    }
+    return failed;
+}
+
+int main(int argc, char **argv) {
+    uint32_t baud = 115200;
+    int bench = 0, idle = 0, boot = 0, lcd = 0, search = 0, opt;
+    const char *eeprom_file = 0, *replay = 0, *save = 0;
+    while ((opt = getopt(argc, argv, "b:p:to:e:BLIWR:x:M:U:TSw:")) != -1) {
+        if (opt == 'b')
+            baud = (uint32_t)strtoul(optarg, 0, 10);
+        else if (opt == 'p')
+            poll_us = (uint32_t)strtoul(optarg, 0, 10);
+        else if (opt == 't')
+            trace = 1;
+        else if (opt == 'B')
+            bench = 1;
+        else if (opt == 'L')
+            lcd = 1;
+        else if (opt == 'I')
+            idle = 1;
+        else if (opt == 'W')
+            boot = 1;
+        else if (opt == 'e')
+            eeprom_file = optarg;
+        else if (opt == 'R')
+            replay = optarg;
+        else if (opt == 'x')
+            replay_speed = strtod(optarg, 0);
+        else if (opt == 'M')
+            malformed_pct = atoi(optarg);
+        else if (opt == 'U')
+            burst_size = atoi(optarg);
+        else if (opt == 'T')
+            text_lines = 1;
+        else if (opt == 'S')
+            search = 1;
+        else if (opt == 'w')
+            save = optarg;
+        else if (opt != 'o')
+            return 2;
+        else if (!(uart0_out = fopen(optarg, "wb"))) {
+            perror(optarg);
+            return 1;
+        }
+    }
+    Host_UART1_Set_Baud(baud);
+    if (bench) {
+        return Run_Bench(baud);
+    }
+    if (lcd)
+        return Run_LCD_Bench();
+    if (idle)
+        return Run_Idle_Check();
+    if (boot)
+        return Run_Boot_Bench();
+    if (replay)
+        return Run_Replay(replay, save, search, baud);
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-b baud] [-p poll_us] [-t] [-o file] [-e file] script|-   or   %s -B|-L|-I|-W|-R src\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    FILE *in = strcmp(argv[optind], "-") == 0 ? stdin : fopen(argv[optind], "r");
+    if (!in) {
+        perror(argv[optind]);
+        return 1;
+    }
+    FILE *image = eeprom_file ? fopen(eeprom_file, "rb") : 0;
+    if (image) {
+        if (fread(host_eeprom, 1, sizeof(host_eeprom), image) != sizeof(host_eeprom))
+            fprintf(stderr, "%s: short EEPROM image, rest left erased\n", eeprom_file);
+        fclose(image);
+    }
+    Tracker_Setup();
+    int result = Run_Script(in);
+    if (uart0_out)
+        fclose(uart0_out);
+    if (eeprom_file && (image = fopen(eeprom_file, "wb"))) {
+        fwrite(host_eeprom, 1, sizeof(host_eeprom), image);
+        fclose(image);
+    }
+    return result;
+}